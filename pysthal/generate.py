@@ -4,6 +4,7 @@ import sys,os, re, logging, argparse
 from pywrap.wrapper import Wrapper
 from pywrap import containers, namespaces, matchers, classes
 from pyplusplus.module_builder import call_policies
+from pygccxml import declarations
 
 wrap = Wrapper()
 mb = wrap.mb
@@ -59,13 +60,53 @@ for f_name in ("receivedSpikes", "sentSpikes"):
     f.call_policies = call_policies.custom_call_policies(
         "::pywrap::ReturnNumpyPolicy", "pysthal/return_numpy_policy.hpp")
 
+# expose columnar spike trains as numpy views without copying
+c = ns_sthal.class_("SpikeTrain")
+c.add_declaration_code('#include "pysthal/spike_train_numpy.hpp"')
+for f_name in ("times", "addrs"):
+    c.member_function(f_name).exclude()
+    c.add_registration_code(
+        'add_property("%s", &::pysthal::spike_train_%s)' % (f_name, f_name))
+f = c.member_function("times_in_s")
+f.call_policies = call_policies.custom_call_policies(
+    "::pywrap::ReturnNumpyPolicy", "pywrap/return_numpy_policy.hpp")
+
 for cls in ['SynapseProxy', 'SynapseRowProxy']:
     c = ns_sthal.class_(cls)
     for var in c.variables():
         var.getter_call_policies = call_policies.return_internal_reference()
+    # leases only track the lifetime of proxies handed out by SynapseArray
+    c.constructors(lambda ctor: len(ctor.arguments) == 3, allow_empty=True).exclude()
+
+for cls in ['SynapseRowLease', 'SynapseRowLeases']:
+    ns_sthal.class_(cls).exclude()
+
+# decoding into raw storage, e.g. memory-mapped files, is not meaningful in python
+c = ns_sthal.class_("CompactPulseEvents")
+c.member_functions(
+    lambda f: f.name == "decode" and len(f.arguments) == 1 and
+    declarations.is_pointer(f.arguments[0].decl_type),
+    allow_empty=True).exclude()
+
+# read-only sequence of received pulse events, valid as long as the FPGA is unchanged
+c = ns_sthal.class_("PulseEventView")
+c.add_declaration_code('#include "pysthal/pulse_event_view.hpp"')
+c.constructors(lambda ctor: len(ctor.arguments) == 2, allow_empty=True).exclude()
+for f_name in ("begin", "end"):
+    c.member_functions(f_name).exclude()
+c.add_registration_code('def("__len__", &::sthal::PulseEventView::size)')
+c.add_registration_code('def("__getitem__", &::pysthal::pulse_event_view_getitem)')
+c.add_registration_code(
+    'def("__iter__", bp::range(&::sthal::PulseEventView::begin, &::sthal::PulseEventView::end))')
+c = ns_sthal.class_("FPGA")
+for f in c.member_functions(
+        lambda f: f.name in ("getReceivedSpikes", "getReceivedPulseEvents") and
+        f.return_type.decl_string.endswith("PulseEventView")):
+    f.call_policies = call_policies.with_custodian_and_ward_postcall(0, 1)
 
 for cls in ['Wafer', 'HICANN', 'HICANNData', 'DNC', 'FPGA', 'Status', 'ADCChannel', 'Spike',
-            'SynapseArray', 'FGStimulus', 'FloatingGates', 'FGConfig']:
+            'SynapseArray', 'FGStimulus', 'FloatingGates', 'FGConfig', 'SpikeTrain',
+            'ReceivedSpikeStatistics']:
     c = ns_sthal.class_(cls)
     classes.add_pickle_suite(c)
 
@@ -100,7 +141,7 @@ mb.add_registration_code(
 
 # somehow the typedefs in sthal::Status had ignore=True,
 # force include them here as a workaround
-for cls in ['Status']:
+for cls in ['Status', 'ReceivedSpikeStatistics']:
     c = ns_sthal.class_(cls)
     for td in c.typedefs():
         td.target_decl.include()
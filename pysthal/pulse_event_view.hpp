@@ -0,0 +1,24 @@
+#pragma once
+
+#include <boost/python.hpp>
+
+#include <sthal/PulseEventView.h>
+
+namespace pysthal {
+
+/// Element access with python semantics: negative indices, IndexError if out of range
+inline ::sthal::PulseEventView::value_type pulse_event_view_getitem(
+    ::sthal::PulseEventView const& view, long index)
+{
+	long const size = static_cast<long>(view.size());
+	if (index < 0) {
+		index += size;
+	}
+	if (index < 0 || index >= size) {
+		PyErr_SetString(PyExc_IndexError, "PulseEventView index out of range");
+		boost::python::throw_error_already_set();
+	}
+	return view[static_cast<size_t>(index)];
+}
+
+} // end namespace pysthal
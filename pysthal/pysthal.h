@@ -10,7 +10,10 @@
 #include "sthal/HICANN.h"
 #include "sthal/ReadFloatingGates.h"
 #include "sthal/ExperimentRunner.h"
+#include "sthal/AsyncExperimentRunner.h"
 #include "sthal/Settings.h"
+#include "sthal/SpikeTrain.h"
+#include "sthal/ReceivedSpikeStatistics.h"
 
 #include "sthal/DNCLoopbackConfigurator.h"
 #include "sthal/DontProgramFloatingGatesHICANNConfigurator.h"
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <boost/python.hpp>
+#include <pyublas/numpy.hpp>
+
+#include <sthal/SpikeTrain.h>
+
+namespace pysthal {
+
+template <typename T>
+struct numpy_typenum;
+
+template <>
+struct numpy_typenum<uint64_t>
+{
+	static constexpr int value = NPY_UINT64;
+};
+
+template <>
+struct numpy_typenum<uint16_t>
+{
+	static constexpr int value = NPY_UINT16;
+};
+
+/// Read-only 1D numpy array onto `data`, which keeps `owner` alive
+template <typename T>
+boost::python::object numpy_view(boost::python::object const& owner, std::vector<T> const& data)
+{
+	npy_intp dims[1] = {static_cast<npy_intp>(data.size())};
+	PyObject* array = PyArray_New(
+	    &PyArray_Type, 1, dims, numpy_typenum<T>::value, nullptr,
+	    const_cast<T*>(data.data()), 0, NPY_ARRAY_CARRAY_RO, nullptr);
+	if (array == nullptr) {
+		boost::python::throw_error_already_set();
+	}
+	Py_INCREF(owner.ptr());
+	if (PyArray_SetBaseObject(reinterpret_cast<PyArrayObject*>(array), owner.ptr()) != 0) {
+		Py_DECREF(array);
+		boost::python::throw_error_already_set();
+	}
+	return boost::python::object(boost::python::handle<>(array));
+}
+
+inline boost::python::object spike_train_times(boost::python::object const& self)
+{
+	sthal::SpikeTrain const& train = boost::python::extract<sthal::SpikeTrain const&>(self);
+	return numpy_view(self, train.times());
+}
+
+inline boost::python::object spike_train_addrs(boost::python::object const& self)
+{
+	sthal::SpikeTrain const& train = boost::python::extract<sthal::SpikeTrain const&>(self);
+	return numpy_view(self, train.addrs());
+}
+
+} // end namespace pysthal
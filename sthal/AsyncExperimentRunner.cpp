@@ -0,0 +1,145 @@
+#include "sthal/AsyncExperimentRunner.h"
+
+#include <exception>
+#include <future>
+#include <vector>
+
+extern "C" {
+#include <omp.h>
+}
+
+#include <log4cxx/logger.h>
+
+#include "hal/backend/FPGABackend.h"
+
+#include "sthal/FPGA.h"
+#include "sthal/Timer.h"
+
+using namespace ::halco::hicann::v2;
+using namespace ::halco::common;
+
+namespace sthal {
+
+namespace {
+
+/// Waits for all futures and rethrows the first stored exception, if any.
+/// All tasks are joined before throwing, so that no task outlives the FPGAs and
+/// handles it operates on.
+void wait_for_all(std::vector<std::future<void> >& futures)
+{
+	std::exception_ptr error;
+	for (auto& future : futures) {
+		try {
+			future.get();
+		} catch (...) {
+			if (!error) {
+				error = std::current_exception();
+			}
+		}
+	}
+	futures.clear();
+	if (error) {
+		std::rethrow_exception(error);
+	}
+}
+
+} // namespace
+
+AsyncExperimentRunner::AsyncExperimentRunner(double run_time_in_s, bool drop_background_events)
+	: ExperimentRunner(run_time_in_s, drop_background_events)
+{
+}
+
+AsyncExperimentRunner::~AsyncExperimentRunner()
+{
+}
+
+void AsyncExperimentRunner::prepare(FPGA& fpga, ::HMF::Handle::FPGA& handle) const
+{
+	fpga.sortSpikes();
+	upload_spikes(fpga, handle);
+	wait_for_upload(handle);
+	LOG4CXX_INFO(getLogger(), "prime experiment of FPGA: " << handle.coordinate());
+	::HMF::FPGA::prime_experiment(handle);
+}
+
+void AsyncExperimentRunner::run(const fpga_list & fpgas, const fpga_handle_list & handles)
+{
+	auto t = Timer::from_literal_string(__PRETTY_FUNCTION__);
+	auto logger = getLogger();
+
+	std::vector<std::pair<FPGA*, ::HMF::Handle::FPGA*> > active;
+	for (auto fpga_c : iter_all<FPGAOnWafer>()) {
+		if (fpgas.at(fpga_c) && handles.at(fpga_c)) {
+			active.emplace_back(fpgas.at(fpga_c).get(), handles.at(fpga_c).get());
+		} else if (fpgas.at(fpga_c)) {
+			// keep behaviour of ExperimentRunner: spikes are sorted even without handle
+			fpgas.at(fpga_c)->sortSpikes();
+		}
+	}
+	LOG4CXX_DEBUG(logger, "starting pipelined experiment run on " << active.size() << " FPGA(s)");
+
+	run_pipeline(
+	    active.size(),
+	    [this, &active](size_t const ii) { prepare(*active[ii].first, *active[ii].second); },
+	    [&active, &logger](size_t const ii) {
+		    LOG4CXX_DEBUG(
+		        logger, "sending start signal to FPGA: " << active[ii].second->coordinate());
+		    ::HMF::FPGA::start_experiment(*active[ii].second);
+	    },
+	    [this, &active](size_t const ii) {
+		    download_spikes(*active[ii].first, *active[ii].second);
+	    });
+
+	LOG4CXX_INFO(
+	    logger, "pipelined execution took " << t.get_ms() << "ms"
+	                                        << " for an experiment run of "
+	                                        << run_time_in_s() * 1e3 << "ms");
+}
+
+void AsyncExperimentRunner::run_pipeline(
+    size_t const n_fpgas, step_type const& prepare, step_type const& start,
+    step_type const& readout)
+{
+	auto t = Timer::from_literal_string(__PRETTY_FUNCTION__);
+
+	std::vector<std::future<void> > futures;
+	futures.reserve(n_fpgas);
+
+	for (size_t ii = 0; ii < n_fpgas; ++ii) {
+		futures.push_back(std::async(std::launch::async, [&prepare, ii]() { prepare(ii); }));
+	}
+	wait_for_all(futures);
+	LOG4CXX_INFO(getTimeLogger(), "preparing FPGAs took " << t.get_ms() << "ms");
+
+	// single global synchronisation point: all FPGAs have to be started together
+	std::exception_ptr error;
+	int const n = static_cast<int>(n_fpgas);
+	#pragma omp parallel for schedule(dynamic)
+	for (int ii = 0; ii < n; ++ii) {
+		try {
+			start(ii);
+		} catch (...) {
+			#pragma omp critical(sthal_async_experiment_start)
+			if (!error) {
+				error = std::current_exception();
+			}
+		}
+	}
+	if (error) {
+		std::rethrow_exception(error);
+	}
+
+	for (size_t ii = 0; ii < n_fpgas; ++ii) {
+		futures.push_back(std::async(std::launch::async, [&readout, ii]() { readout(ii); }));
+	}
+	wait_for_all(futures);
+}
+
+std::ostream& operator<<(std::ostream& out, AsyncExperimentRunner const& obj)
+{
+	out << "AsyncExperimentRunner(" << obj.time() << "us)";
+	return out;
+}
+
+} // end namespace sthal
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <functional>
+
+#include "sthal/ExperimentRunner.h"
+
+namespace sthal {
+
+/// Experiment runner that pipelines the preparation and readout of each FPGA.
+///
+/// In contrast to ExperimentRunner, which waits for all FPGAs to finish a
+/// phase (sort, upload, readout) before starting the next one, every FPGA
+/// proceeds through sort -> upload -> prime independently.  The only global
+/// synchronisation point is the start of the experiment, which has to be
+/// issued to all FPGAs at once.  Afterwards, trace memory readout and decoding
+/// again run independently per FPGA.
+class AsyncExperimentRunner :
+	public ExperimentRunner
+{
+public:
+	AsyncExperimentRunner(double run_time_in_s, bool drop_background_events = false);
+	virtual ~AsyncExperimentRunner();
+
+	virtual void run(const fpga_list & fpgas, const fpga_handle_list & handles);
+
+#ifndef PYPLUSPLUS
+	typedef std::function<void(size_t fpga)> step_type;
+
+	/**
+	 * @brief Schedules the steps of run() for FPGAs [0, n_fpgas), given as callbacks
+	 * taking the index of the FPGA.
+	 * prepare and readout run as one task per FPGA, start is issued to all FPGAs in
+	 * parallel once all of them are prepared. All tasks of a phase are joined before
+	 * the first exception of the phase is rethrown, later phases are skipped then.
+	 */
+	static void run_pipeline(
+	    size_t n_fpgas, step_type const& prepare, step_type const& start,
+	    step_type const& readout);
+#endif // !PYPLUSPLUS
+
+protected:
+	/// sort, upload and prime a single FPGA
+	void prepare(FPGA& fpga, ::HMF::Handle::FPGA& handle) const;
+};
+
+std::ostream& operator<<(std::ostream& out, AsyncExperimentRunner const& obj);
+
+} // end namespace sthal
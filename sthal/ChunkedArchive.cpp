@@ -0,0 +1,158 @@
+#include "sthal/ChunkedArchive.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <tuple>
+
+namespace sthal {
+
+namespace {
+
+char const magic[8] = {'S', 'T', 'H', 'A', 'L', 'C', 'H', 'K'};
+uint32_t const format_version = 1;
+
+template <typename T>
+void write_value(std::ostream& stream, T const& value)
+{
+	stream.write(reinterpret_cast<char const*>(&value), sizeof(T));
+}
+
+template <typename T>
+T read_value(std::istream& stream)
+{
+	T value;
+	stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+	return value;
+}
+
+} // anonymous namespace
+
+bool operator==(ChunkedArchive::Key const& a, ChunkedArchive::Key const& b)
+{
+	return a.type == b.type && a.id == b.id;
+}
+
+bool operator<(ChunkedArchive::Key const& a, ChunkedArchive::Key const& b)
+{
+	return std::tie(a.type, a.id) < std::tie(b.type, b.id);
+}
+
+ChunkedArchive::ChunkedArchive(std::string const& filename) : m_filename(filename)
+{
+	std::ifstream stream(filename, std::ios::binary);
+	char header[sizeof(magic)];
+	if (!stream.read(header, sizeof(header)) || std::memcmp(header, magic, sizeof(magic)) != 0) {
+		throw std::runtime_error("'" + filename + "' is no chunked archive");
+	}
+	uint32_t const version = read_value<uint32_t>(stream);
+	if (version != format_version) {
+		throw std::runtime_error(
+			"'" + filename + "' has unsupported chunked archive version " +
+			std::to_string(version));
+	}
+	uint32_t const n_chunks = read_value<uint32_t>(stream);
+	m_index.reserve(n_chunks);
+	for (uint32_t ii = 0; ii < n_chunks; ++ii) {
+		Entry entry;
+		entry.key.type = read_value<uint32_t>(stream);
+		entry.key.id = read_value<uint32_t>(stream);
+		entry.offset = read_value<uint64_t>(stream);
+		entry.size = read_value<uint64_t>(stream);
+		m_index.push_back(entry);
+	}
+	if (!stream) {
+		throw std::runtime_error("'" + filename + "' has a truncated chunk index");
+	}
+	std::sort(m_index.begin(), m_index.end(), [](Entry const& a, Entry const& b) {
+		return a.key < b.key;
+	});
+}
+
+void ChunkedArchive::write(std::string const& filename, chunks_type const& chunks)
+{
+	std::ofstream stream(filename, std::ios::binary | std::ios::trunc);
+	if (!stream) {
+		throw std::runtime_error("cannot open '" + filename + "' for writing");
+	}
+
+	size_t const entry_size = 2 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+	uint64_t offset =
+		sizeof(magic) + 2 * sizeof(uint32_t) + chunks.size() * entry_size;
+
+	stream.write(magic, sizeof(magic));
+	write_value(stream, format_version);
+	write_value(stream, static_cast<uint32_t>(chunks.size()));
+	for (auto const& chunk : chunks) {
+		write_value(stream, chunk.first.type);
+		write_value(stream, chunk.first.id);
+		write_value(stream, offset);
+		write_value(stream, static_cast<uint64_t>(chunk.second.size()));
+		offset += chunk.second.size();
+	}
+	for (auto const& chunk : chunks) {
+		stream.write(chunk.second.data(), chunk.second.size());
+	}
+	if (!stream) {
+		throw std::runtime_error("writing '" + filename + "' failed");
+	}
+}
+
+bool ChunkedArchive::is_chunked_archive(std::string const& filename)
+{
+	std::ifstream stream(filename, std::ios::binary);
+	char header[sizeof(magic)];
+	return stream.read(header, sizeof(header)) &&
+	       std::memcmp(header, magic, sizeof(magic)) == 0;
+}
+
+std::string const& ChunkedArchive::filename() const
+{
+	return m_filename;
+}
+
+std::vector<ChunkedArchive::Key> ChunkedArchive::keys() const
+{
+	std::vector<Key> ret;
+	ret.reserve(m_index.size());
+	for (auto const& entry : m_index) {
+		ret.push_back(entry.key);
+	}
+	return ret;
+}
+
+bool ChunkedArchive::has(Key const& key) const
+{
+	return std::binary_search(
+		m_index.begin(), m_index.end(), Entry{key, 0, 0},
+		[](Entry const& a, Entry const& b) { return a.key < b.key; });
+}
+
+ChunkedArchive::Entry const& ChunkedArchive::find(Key const& key) const
+{
+	auto const it = std::lower_bound(
+		m_index.begin(), m_index.end(), Entry{key, 0, 0},
+		[](Entry const& a, Entry const& b) { return a.key < b.key; });
+	if (it == m_index.end() || !(it->key == key)) {
+		throw std::out_of_range(
+			"no chunk " + std::to_string(key.type) + "/" + std::to_string(key.id) + " in '" +
+			m_filename + "'");
+	}
+	return *it;
+}
+
+std::string ChunkedArchive::read(Key const& key) const
+{
+	Entry const& entry = find(key);
+	// own stream per call, so chunks can be read concurrently
+	std::ifstream stream(m_filename, std::ios::binary);
+	stream.seekg(entry.offset);
+	std::string data(entry.size, '\0');
+	if (!stream.read(&data[0], entry.size)) {
+		throw std::runtime_error("'" + m_filename + "' has a truncated chunk");
+	}
+	return data;
+}
+
+} // end namespace sthal
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sthal {
+
+/**
+ * @brief File of independently serialized chunks with an index header.
+ *
+ * Layout: magic, format version, number of chunks, one index entry (key, offset,
+ * size) per chunk, followed by the chunk data. Chunks are identified by a type and
+ * an id, e.g. the enum of a coordinate. The index allows reading single chunks
+ * without touching the rest of the file.
+ */
+class ChunkedArchive
+{
+public:
+	struct Key
+	{
+		uint32_t type;
+		uint32_t id;
+
+		friend bool operator==(Key const& a, Key const& b);
+		friend bool operator<(Key const& a, Key const& b);
+	};
+
+	typedef std::vector<std::pair<Key, std::string> > chunks_type;
+
+	/// Opens a chunked archive and reads its index
+	/// @throw std::runtime_error if the file cannot be read or is no chunked archive
+	explicit ChunkedArchive(std::string const& filename);
+
+	/// Writes chunks into a new chunked archive, replacing filename
+	static void write(std::string const& filename, chunks_type const& chunks);
+
+	/// Whether filename starts like a chunked archive
+	static bool is_chunked_archive(std::string const& filename);
+
+	std::string const& filename() const;
+
+	std::vector<Key> keys() const;
+	bool has(Key const& key) const;
+
+	/// Reads the data of a chunk, safe to be called concurrently
+	/// @throw std::out_of_range if there is no chunk with key
+	std::string read(Key const& key) const;
+
+private:
+	struct Entry
+	{
+		Key key;
+		uint64_t offset;
+		uint64_t size;
+	};
+
+	Entry const& find(Key const& key) const;
+
+	std::string m_filename;
+	// sorted by key
+	std::vector<Entry> m_index;
+};
+
+} // end namespace sthal
@@ -0,0 +1,144 @@
+#include "sthal/CompactPulseEvents.h"
+
+#include <iterator>
+#include <stdexcept>
+
+#include "halco/hicann/v2/l1.h"
+
+using namespace ::halco::hicann::v2;
+using namespace ::halco::common;
+
+namespace sthal {
+
+namespace {
+
+/// L1 addresses are 6 bit wide
+size_t const l1_address_bits = 6;
+
+void put_varint(std::vector<uint8_t>& data, uint64_t value)
+{
+	while (value >= 0x80) {
+		data.push_back(static_cast<uint8_t>(value | 0x80));
+		value >>= 7;
+	}
+	data.push_back(static_cast<uint8_t>(value));
+}
+
+uint64_t get_varint(std::vector<uint8_t>::const_iterator& it, std::vector<uint8_t>::const_iterator const end)
+{
+	uint64_t value = 0;
+	for (size_t shift = 0; shift < 64; shift += 7) {
+		if (it == end) {
+			throw std::runtime_error("CompactPulseEvents: truncated data");
+		}
+		uint8_t const byte = *it++;
+		value |= uint64_t(byte & 0x7f) << shift;
+		if (!(byte & 0x80)) {
+			return value;
+		}
+	}
+	throw std::runtime_error("CompactPulseEvents: malformed varint");
+}
+
+uint64_t zigzag(int64_t const value)
+{
+	return (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+}
+
+int64_t unzigzag(uint64_t const value)
+{
+	return int64_t(value >> 1) ^ -int64_t(value & 1);
+}
+
+} // namespace
+
+CompactPulseEvents::CompactPulseEvents() : m_size(0)
+{
+}
+
+CompactPulseEvents::CompactPulseEvents(container_type const& events)
+	: CompactPulseEvents(events.data(), events.data() + events.size())
+{
+}
+
+CompactPulseEvents::CompactPulseEvents(PulseEvent const* const begin, PulseEvent const* const end)
+	: m_size(std::distance(begin, end))
+{
+	// typically 1-2 bytes for the time delta and 2 bytes for the address
+	m_data.reserve(4 * m_size);
+
+	uint64_t last_time = 0;
+	for (auto it = begin; it != end; ++it) {
+		auto const& event = *it;
+		uint64_t const time = event.getTime();
+		put_varint(m_data, zigzag(int64_t(time - last_time)));
+		last_time = time;
+
+		uint64_t const merger =
+		    (uint64_t(event.getDncAddress().value()) * HICANNOnDNC::enum_type::size +
+		     event.getChipAddress().toEnum().value()) *
+		        GbitLinkOnHICANN::size +
+		    event.getChannel().value();
+		put_varint(m_data, (merger << l1_address_bits) | event.getNeuronAddress().value());
+	}
+	m_data.shrink_to_fit();
+}
+
+void CompactPulseEvents::decode(container_type& events) const
+{
+	size_t const offset = events.size();
+	events.resize(offset + m_size);
+	decode(events.data() + offset);
+}
+
+void CompactPulseEvents::decode(PulseEvent* const events) const
+{
+	auto it = m_data.cbegin();
+	uint64_t time = 0;
+	for (size_t ii = 0; ii < m_size; ++ii) {
+		time += unzigzag(get_varint(it, m_data.cend()));
+
+		uint64_t const key = get_varint(it, m_data.cend());
+		uint64_t const merger = key >> l1_address_bits;
+		size_t const channel = merger % GbitLinkOnHICANN::size;
+		size_t const chip = (merger / GbitLinkOnHICANN::size) % HICANNOnDNC::enum_type::size;
+		size_t const dnc = merger / GbitLinkOnHICANN::size / HICANNOnDNC::enum_type::size;
+
+		events[ii] = PulseEvent(
+		    PulseEvent::dnc_address_t(dnc), PulseEvent::chip_address_t(Enum(chip)),
+		    PulseEvent::channel_t(channel),
+		    ::HMF::HICANN::L1Address(key & ((1u << l1_address_bits) - 1)), time);
+	}
+	if (it != m_data.cend()) {
+		throw std::runtime_error("CompactPulseEvents: trailing data");
+	}
+}
+
+CompactPulseEvents::container_type CompactPulseEvents::decode() const
+{
+	container_type events;
+	decode(events);
+	return events;
+}
+
+size_t CompactPulseEvents::size() const
+{
+	return m_size;
+}
+
+size_t CompactPulseEvents::bytes() const
+{
+	return m_data.size();
+}
+
+bool operator==(CompactPulseEvents const& a, CompactPulseEvents const& b)
+{
+	return a.m_size == b.m_size && a.m_data == b.m_data;
+}
+
+bool operator!=(CompactPulseEvents const& a, CompactPulseEvents const& b)
+{
+	return !(a == b);
+}
+
+} // end namespace sthal
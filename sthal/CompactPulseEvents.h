@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/version.hpp>
+
+#include "hal/FPGAContainer.h"
+
+namespace sthal {
+
+/**
+ * @brief Compact encoding of a sequence of pulse events for archives.
+ * Each event is stored as two varints (LEB128): the zigzag encoded difference
+ * to the timestamp of the previous event and the L1 address packed together
+ * with DNC, HICANN and DNC merger. For time-sorted sequences the timestamp
+ * deltas are small, so that a typical event takes 3-4 bytes instead of the
+ * element-wise serialization of PulseEvent. Any order is encoded losslessly.
+ */
+class CompactPulseEvents
+{
+public:
+	typedef ::HMF::FPGA::PulseEvent PulseEvent;
+	typedef std::vector<PulseEvent> container_type;
+
+	CompactPulseEvents();
+	explicit CompactPulseEvents(container_type const& events);
+	CompactPulseEvents(PulseEvent const* begin, PulseEvent const* end);
+
+	/// append decoded events to `events`
+	void decode(container_type& events) const;
+	/// write the size() decoded events to `events`, e.g. into a memory-mapped file
+	void decode(PulseEvent* events) const;
+	container_type decode() const;
+
+	/// number of encoded events
+	size_t size() const;
+	/// size of the encoded data in bytes
+	size_t bytes() const;
+
+	friend bool operator==(CompactPulseEvents const& a, CompactPulseEvents const& b);
+	friend bool operator!=(CompactPulseEvents const& a, CompactPulseEvents const& b);
+
+private:
+	uint64_t m_size;
+	std::vector<uint8_t> m_data;
+
+	friend class boost::serialization::access;
+	template <typename Archiver>
+	void serialize(Archiver& ar, unsigned int const)
+	{
+		using boost::serialization::make_nvp;
+		ar & make_nvp("size", m_size)
+		   & make_nvp("data", m_data);
+	}
+};
+
+} // end namespace sthal
+
+BOOST_CLASS_VERSION(sthal::CompactPulseEvents, 0)
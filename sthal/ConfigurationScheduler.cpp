@@ -0,0 +1,173 @@
+#include "sthal/ConfigurationScheduler.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+extern "C" {
+#include <omp.h>
+}
+
+#include <log4cxx/logger.h>
+
+#include "sthal/Timer.h"
+
+namespace sthal {
+
+namespace {
+log4cxx::LoggerPtr logger = log4cxx::Logger::getLogger("sthal.ConfigurationScheduler");
+} // namespace
+
+ConfigurationScheduler::ConfigurationScheduler(
+    Settings::CfgStages const& stages, std::vector<size_t> const& l1_groups)
+	: m_n_fpgas(l1_groups.size())
+{
+	auto const& order = stages.order;
+	size_t const n_stages = order.size();
+	auto const node_index = [n_stages](size_t fpga, size_t position) {
+		return fpga * n_stages + position;
+	};
+
+	m_nodes.resize(m_n_fpgas * n_stages);
+	for (size_t fpga = 0; fpga < m_n_fpgas; ++fpga) {
+		for (size_t position = 0; position < n_stages; ++position) {
+			Node& node = m_nodes[node_index(fpga, position)];
+			node.fpga = fpga;
+			node.stage = order[position];
+			auto const sleep = stages.sleeps.find(node.stage);
+			node.settle = std::chrono::milliseconds(
+			    sleep != stages.sleeps.end() ? sleep->second : 0);
+			node.missing = 0;
+		}
+	}
+
+	for (size_t fpga = 0; fpga < m_n_fpgas; ++fpga) {
+		for (size_t position = 1; position < n_stages; ++position) {
+			add_edge(node_index(fpga, position - 1), node_index(fpga, position));
+		}
+	}
+
+	for (auto const& item : stages.l1_dependencies) {
+		auto const stage_it = std::find(order.begin(), order.end(), item.first);
+		if (stage_it == order.end()) {
+			continue;
+		}
+		size_t const position = std::distance(order.begin(), stage_it);
+
+		for (auto const dependency : item.second) {
+			auto const dependency_it = std::find(order.begin(), stage_it, dependency);
+			if (dependency_it == stage_it) {
+				std::stringstream err;
+				err << "L1 dependency " << static_cast<size_t>(dependency) << " of stage "
+				    << static_cast<size_t>(item.first) << " is not configured before it";
+				throw std::invalid_argument(err.str());
+			}
+			size_t const dependency_position = std::distance(order.begin(), dependency_it);
+
+			for (size_t fpga = 0; fpga < m_n_fpgas; ++fpga) {
+				for (size_t other = 0; other < m_n_fpgas; ++other) {
+					if (other != fpga && l1_groups[other] == l1_groups[fpga]) {
+						add_edge(
+						    node_index(other, dependency_position), node_index(fpga, position));
+					}
+				}
+			}
+		}
+	}
+}
+
+void ConfigurationScheduler::add_edge(size_t const from, size_t const to)
+{
+	m_nodes[from].dependents.push_back(to);
+	++m_nodes[to].missing;
+}
+
+size_t ConfigurationScheduler::size() const
+{
+	return m_nodes.size();
+}
+
+void ConfigurationScheduler::run(work_type const& work)
+{
+	typedef std::chrono::steady_clock clock;
+
+	std::mutex mutex;
+	std::condition_variable cv;
+	std::exception_ptr error;
+
+	std::vector<size_t> missing(m_nodes.size());
+	std::vector<clock::time_point> ready_at(m_nodes.size(), clock::now());
+	std::multimap<clock::time_point, size_t> ready;
+	for (size_t ii = 0; ii < m_nodes.size(); ++ii) {
+		missing[ii] = m_nodes[ii].missing;
+		if (!missing[ii]) {
+			ready.emplace(ready_at[ii], ii);
+		}
+	}
+	size_t remaining = m_nodes.size();
+	size_t running = 0;
+
+	int const n_threads = std::max(1, std::min(omp_get_max_threads(), static_cast<int>(m_n_fpgas)));
+
+	#pragma omp parallel num_threads(n_threads)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		while (remaining && !(error && !running)) {
+			if (error || ready.empty()) {
+				cv.wait(lock);
+				continue;
+			}
+			auto const next = ready.begin();
+			if (next->first > clock::now()) {
+				// settle time of a dependency not yet elapsed
+				cv.wait_until(lock, next->first);
+				continue;
+			}
+			size_t const index = next->second;
+			ready.erase(next);
+			++running;
+
+			Node const& node = m_nodes[index];
+			lock.unlock();
+			Timer t;
+			try {
+				work(node.fpga, node.stage);
+			} catch (...) {
+				lock.lock();
+				if (!error) {
+					error = std::current_exception();
+				}
+				--running;
+				cv.notify_all();
+				continue;
+			}
+			LOG4CXX_DEBUG(
+			    logger, "stage " << static_cast<size_t>(node.stage) << " of FPGA #" << node.fpga
+			                     << " took " << t.get_ms() << "ms, settling for "
+			                     << node.settle.count() << "ms");
+			lock.lock();
+
+			--running;
+			--remaining;
+			auto const settled = clock::now() + node.settle;
+			for (size_t const dependent : node.dependents) {
+				ready_at[dependent] = std::max(ready_at[dependent], settled);
+				if (--missing[dependent] == 0) {
+					ready.emplace(ready_at[dependent], dependent);
+				}
+			}
+			cv.notify_all();
+		}
+		cv.notify_all();
+	}
+
+	if (error) {
+		std::rethrow_exception(error);
+	}
+}
+
+} // end namespace sthal
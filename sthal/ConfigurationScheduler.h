@@ -0,0 +1,57 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <vector>
+
+#include "sthal/ConfigurationStages.h"
+#include "sthal/Settings.h"
+
+namespace sthal {
+
+/**
+ * @brief Runs the configuration stages of several FPGAs as a dependency graph.
+ *
+ * Nodes are (FPGA, stage) pairs. A node depends on
+ *  - the preceding stage of Settings::CfgStages::order on the same FPGA and
+ *  - the stages listed in Settings::CfgStages::l1_dependencies on all FPGAs of
+ *    the same L1 group, i.e. FPGAs coupled via adjacent allocated HICANNs.
+ * A node becomes ready once all its dependencies have finished and their
+ * settle times (Settings::CfgStages::sleeps) have elapsed. Ready nodes are
+ * executed by the OpenMP threads, so that an FPGA does not wait for unrelated
+ * FPGAs at stage boundaries.
+ */
+class ConfigurationScheduler
+{
+public:
+	typedef std::function<void(size_t fpga, ConfigurationStage stage)> work_type;
+
+	/**
+	 * @param stages Stage order, settle times and L1 dependencies.
+	 * @param l1_groups Group id per FPGA (index into the list of FPGAs to configure).
+	 * @throw std::invalid_argument if an L1 dependency does not precede its stage.
+	 */
+	ConfigurationScheduler(Settings::CfgStages const& stages, std::vector<size_t> const& l1_groups);
+
+	/// Execute `work` for all nodes, rethrows the first exception after running nodes finished
+	void run(work_type const& work);
+
+	size_t size() const;
+
+private:
+	struct Node
+	{
+		size_t fpga;
+		ConfigurationStage stage;
+		std::chrono::milliseconds settle;
+		std::vector<size_t> dependents;
+		size_t missing;
+	};
+
+	void add_edge(size_t from, size_t to);
+
+	std::vector<Node> m_nodes;
+	size_t m_n_fpgas;
+};
+
+} // end namespace sthal
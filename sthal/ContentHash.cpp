@@ -0,0 +1,41 @@
+#include "sthal/ContentHash.h"
+
+namespace sthal {
+
+namespace {
+uint64_t const fnv_offset_basis = 14695981039346656037ull;
+uint64_t const fnv_prime = 1099511628211ull;
+} // anonymous namespace
+
+uint64_t hash_combine(uint64_t seed, uint64_t value)
+{
+	return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+}
+
+HashStreamBuffer::HashStreamBuffer() : m_hash(fnv_offset_basis)
+{
+}
+
+uint64_t HashStreamBuffer::hash() const
+{
+	return m_hash;
+}
+
+std::streamsize HashStreamBuffer::xsputn(char_type const* s, std::streamsize n)
+{
+	for (std::streamsize ii = 0; ii < n; ++ii) {
+		m_hash = (m_hash ^ static_cast<unsigned char>(s[ii])) * fnv_prime;
+	}
+	return n;
+}
+
+HashStreamBuffer::int_type HashStreamBuffer::overflow(int_type c)
+{
+	if (!traits_type::eq_int_type(c, traits_type::eof())) {
+		char_type const ch = traits_type::to_char_type(c);
+		xsputn(&ch, 1);
+	}
+	return traits_type::not_eof(c);
+}
+
+} // end namespace sthal
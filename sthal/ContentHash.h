@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <streambuf>
+
+#ifndef PYPLUSPLUS
+#include <boost/archive/binary_oarchive.hpp>
+#endif // !PYPLUSPLUS
+
+namespace sthal {
+
+/// Combines two hash values (64 bit variant of boost::hash_combine)
+uint64_t hash_combine(uint64_t seed, uint64_t value);
+
+#ifndef PYPLUSPLUS
+/// Stream buffer computing the 64 bit FNV-1a hash of everything written to it
+class HashStreamBuffer : public std::streambuf
+{
+public:
+	HashStreamBuffer();
+
+	uint64_t hash() const;
+
+protected:
+	std::streamsize xsputn(char_type const* s, std::streamsize n) override;
+	int_type overflow(int_type c) override;
+
+private:
+	uint64_t m_hash;
+};
+
+/// 64 bit content hash of a serializable object, i.e. the hash of its binary
+/// archive representation. Hashes are only comparable between builds of the
+/// same version on the same platform, they are not meant to be stored.
+template <typename T>
+uint64_t content_hash(T const& obj)
+{
+	HashStreamBuffer buffer;
+	{
+		std::ostream stream(&buffer);
+		boost::archive::binary_oarchive ar(
+			stream, boost::archive::no_header | boost::archive::no_tracking);
+		ar << obj;
+	}
+	return buffer.hash();
+}
+#endif // !PYPLUSPLUS
+
+} // end namespace sthal
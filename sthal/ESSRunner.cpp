@@ -93,23 +93,15 @@ void ESSRunner::run(const fpga_list & fpgas,
 			auto result =
 			    ::HMF::FPGA::read_trace_pulses(fpga_handle, 0 /*runtime not used in ESS*/);
 
-			size_t background_events = 0;
-			size_t const total_events = result.size();
-			if (!drop_bg_events) {
-				// L1Address(0) is reserved for background events
-				const ::HMF::HICANN::L1Address bkg_address(0);
-				for (auto const& pulse_event : result) {
-					if (pulse_event.getNeuronAddress() == bkg_address) {
-						++background_events;
-					}
-				}
-			}
+			auto const stats =
+			    ReceivedSpikeStatistics::collect(result, drop_bg_events, this->time());
 
 			fpga->setReceivedPulseEvents(std::move(result));
+			fpga->setReceivedSpikeStatistics(stats);
 
 			LOG4CXX_INFO(
-				getLogger(), "received " << total_events
-				<< " (" << (total_events - background_events)
+				getLogger(), "received " << stats.total
+				<< " (" << (stats.total - stats.background)
 				<< ") spikes (not background) from FPGA: " << fpga_handle.coordinate());
 		}
 	}
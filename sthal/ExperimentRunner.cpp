@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <sstream>
 #include <chrono>
+#include <future>
 #include <sstream>
 #include <thread>
 
@@ -63,6 +64,73 @@ void ExperimentRunner::run(const fpga_list & fpgas, const fpga_handle_list & han
 	                                   << "ms");
 }
 
+batch_pulse_events ExperimentRunner::run_batch(
+    const fpga_list & fpgas,
+    const fpga_handle_list & handles,
+    batch_pulse_events const& stimuli)
+{
+	auto t = Timer::from_literal_string(__PRETTY_FUNCTION__);
+	auto logger = getLogger();
+
+	typedef typed_array<FPGA::PulseEventContainer, FPGAOnWafer> prepared_type;
+
+	// one result buffer per run, readout results are moved into them
+	batch_pulse_events results(stimuli.size());
+	if (stimuli.empty()) {
+		return results;
+	}
+
+	auto const prepare = [&fpgas, &handles, &stimuli](size_t const run) {
+		prepared_type prepared;
+		for (auto fpga_c : iter_all<FPGAOnWafer>()) {
+			if (fpgas.at(fpga_c) && handles.at(fpga_c)) {
+				auto events = stimuli[run].at(fpga_c);
+				prepared[fpga_c] = FPGA::PulseEventContainer(std::move(events));
+			}
+		}
+		return prepared;
+	};
+
+	FPGA::PulseEvent::spiketime_t const duration =
+		FPGA::dnc_freq_in_MHz * this->m_run_time_in_us;
+
+	std::future<prepared_type> next = std::async(std::launch::async, prepare, 0);
+	for (size_t run = 0; run < stimuli.size(); ++run) {
+		prepared_type const current = next.get();
+
+		#pragma omp parallel for schedule(dynamic)
+		for (size_t fpga_enum = 0; fpga_enum < FPGAOnWafer::end; ++fpga_enum) {
+			FPGAOnWafer const fpga_c{Enum(fpga_enum)};
+			if (fpgas.at(fpga_c) && handles.at(fpga_c)) {
+				upload_spikes(*fpgas.at(fpga_c), *handles.at(fpga_c), current.at(fpga_c));
+				wait_for_upload(*handles.at(fpga_c));
+			}
+		}
+
+		// sort the stimulus of the following run while this one is executed
+		if (run + 1 < stimuli.size()) {
+			next = std::async(std::launch::async, prepare, run + 1);
+		}
+
+		start_experiment(fpgas, handles);
+
+		#pragma omp parallel for schedule(dynamic)
+		for (size_t fpga_enum = 0; fpga_enum < FPGAOnWafer::end; ++fpga_enum) {
+			FPGAOnWafer const fpga_c{Enum(fpga_enum)};
+			if (fpgas.at(fpga_c) && handles.at(fpga_c)) {
+				results[run][fpga_c] = ::HMF::FPGA::read_trace_pulses(*handles.at(fpga_c), duration);
+				LOG4CXX_DEBUG(
+				    logger, "run " << run << ": received " << results[run][fpga_c].size()
+				                   << " spike(s) from FPGA: " << handles.at(fpga_c)->coordinate());
+			}
+		}
+	}
+
+	LOG4CXX_INFO(
+	    getTimeLogger(), "batch of " << stimuli.size() << " run(s) took " << t.get_ms() << "ms");
+	return results;
+}
+
 void ExperimentRunner::sort_spikes(fpga_list const& fpgas)
 {
 	auto t = Timer::from_literal_string(__PRETTY_FUNCTION__);
@@ -90,54 +158,66 @@ void ExperimentRunner::send_spikes(const fpga_list & fpgas, const fpga_handle_li
 		FPGAOnWafer const fpga_c{Enum(fpga_enum)};
 
 		if (fpgas.at(fpga_c) && handles.at(fpga_c)) {
-			FPGA& fpga = *fpgas.at(fpga_c);
-			::HMF::Handle::FPGA& handle = *handles.at(fpga_c);
-
-			// reset hostal FPGA timestamp counter
-			::HMF::FPGA::reset_pbmem(handle);
-
-			// upload spike data and insert end-of-experiment marker
-			auto const& spikes = fpga.getSendSpikes();
-			LOG4CXX_INFO(logger, "sending " << spikes.size()
-			                                << " to FPGA: " << handle.coordinate());
-			FPGA::PulseEvent::spiketime_t const endtime =
-				FPGA::dnc_freq_in_MHz * this->m_run_time_in_us;
-			::HMF::FPGA::write_playback_program(
-			    handle, spikes, endtime, fpga.commonFPGASettings()->getFPGAHICANNDelay(),
-			    fpga.hasOutboundMergers(), m_drop_background_events);
+			upload_spikes(*fpgas.at(fpga_c), *handles.at(fpga_c));
 		}
 	}
 
-	// FIXME: move expecting-answer-timeout to communication layer
-	std::chrono::milliseconds const timeout{1000};
-
 	// Wait for response from all FPGAs that experiment was written to Playback memory
 	#pragma omp parallel for schedule(dynamic)
 	for (size_t fpga_enum = 0; fpga_enum < FPGAOnWafer::end; ++fpga_enum) {
 		FPGAOnWafer const fpga_c{Enum(fpga_enum)};
 		if (!(fpgas.at(fpga_c) && handles.at(fpga_c)))
 			continue;
-		HMF::Handle::FPGA& handle = *handles.at(fpga_c);
-
-		auto const start = std::chrono::steady_clock::now();
-		auto now = start;
-
-		// wait for new data in 10us slices (for up to 1s, cf. FIXME above)
-		while (!HMF::FPGA::get_pbmem_buffering_completed(handle)) {
-			std::chrono::microseconds const sleep_interval{10};
-			std::this_thread::sleep_for(sleep_interval);
-			now = std::chrono::steady_clock::now();
-			if ((now - start) > timeout) {
-				std::stringstream debug_msg;
-				debug_msg << "write_playback_program: no end of experiment response from FPGA "
-				          << handle.coordinate();
-				throw std::runtime_error(debug_msg.str());
-			}
-		}
+		wait_for_upload(*handles.at(fpga_c));
 	}
 	LOG4CXX_INFO(getTimeLogger(), "sending spikes to FPGAs took " << t.get_ms() << "ms");
 }
 
+void ExperimentRunner::upload_spikes(FPGA& fpga, ::HMF::Handle::FPGA& handle) const
+{
+	upload_spikes(fpga, handle, fpga.getSendSpikes());
+}
+
+void ExperimentRunner::upload_spikes(
+    FPGA const& fpga,
+    ::HMF::Handle::FPGA& handle,
+    ::HMF::FPGA::PulseEventContainer const& spikes) const
+{
+	// reset hostal FPGA timestamp counter
+	::HMF::FPGA::reset_pbmem(handle);
+
+	// upload spike data and insert end-of-experiment marker
+	LOG4CXX_INFO(getLogger(), "sending " << spikes.size()
+	                                     << " to FPGA: " << handle.coordinate());
+	FPGA::PulseEvent::spiketime_t const endtime =
+		FPGA::dnc_freq_in_MHz * this->m_run_time_in_us;
+	::HMF::FPGA::write_playback_program(
+	    handle, spikes, endtime, fpga.commonFPGASettings()->getFPGAHICANNDelay(),
+	    fpga.hasOutboundMergers(), m_drop_background_events);
+}
+
+void ExperimentRunner::wait_for_upload(::HMF::Handle::FPGA& handle) const
+{
+	// FIXME: move expecting-answer-timeout to communication layer
+	std::chrono::milliseconds const timeout{1000};
+
+	auto const start = std::chrono::steady_clock::now();
+	auto now = start;
+
+	// wait for new data in 10us slices (for up to 1s, cf. FIXME above)
+	while (!HMF::FPGA::get_pbmem_buffering_completed(handle)) {
+		std::chrono::microseconds const sleep_interval{10};
+		std::this_thread::sleep_for(sleep_interval);
+		now = std::chrono::steady_clock::now();
+		if ((now - start) > timeout) {
+			std::stringstream debug_msg;
+			debug_msg << "write_playback_program: no end of experiment response from FPGA "
+			          << handle.coordinate();
+			throw std::runtime_error(debug_msg.str());
+		}
+	}
+}
+
 void ExperimentRunner::start_experiment(const fpga_list & fpgas, const fpga_handle_list & handles)
 {
 	auto t = Timer::from_literal_string(__PRETTY_FUNCTION__);
@@ -169,60 +249,53 @@ void ExperimentRunner::start_experiment(const fpga_list & fpgas, const fpga_hand
 void ExperimentRunner::receive_spikes(const fpga_list & fpgas, const fpga_handle_list & handles)
 {
 	auto t = Timer::from_literal_string(__PRETTY_FUNCTION__);
-	auto logger = getLogger();
-	LOG4CXX_DEBUG(logger, "receiving spikes from FPGAs");
-	// L1Address(0) is reserved for background events
-	const ::HMF::HICANN::L1Address bkg_address(0);
+	LOG4CXX_DEBUG(getLogger(), "receiving spikes from FPGAs");
 
 	#pragma omp parallel for schedule(dynamic)
 	for (size_t fpga_enum = 0; fpga_enum < FPGAOnWafer::end; ++fpga_enum) {
 		FPGAOnWafer const fpga_c{Enum(fpga_enum)};
 		if (fpgas.at(fpga_c) && handles.at(fpga_c)) {
-			::HMF::Handle::FPGA& handle = *handles.at(fpga_c);
-			FPGA& fpga = *fpgas.at(fpga_c);
-			FPGA::PulseEvent::spiketime_t const duration =
-				FPGA::dnc_freq_in_MHz * this->m_run_time_in_us;
-			auto const& result = ::HMF::FPGA::read_trace_pulses(handle, duration);
-
-			size_t const total_events = result.size();
-			if (!m_drop_background_events) {
-				size_t background_events = 0;
-				for (auto const& pulse_event : result) {
-					if (pulse_event.getNeuronAddress() == bkg_address) {
-						++background_events;
-					}
-				}
-				LOG4CXX_INFO(
-					logger, "received " << total_events
-					<< " (" << (total_events - background_events)
-					<< ") spikes (not background) from FPGA: " << handle.coordinate());
-			} else {
-				LOG4CXX_INFO(logger, "received " << total_events << " spike(s) from FPGA: " << handle.coordinate());
-			}
+			download_spikes(*fpgas.at(fpga_c), *handles.at(fpga_c));
+		}
+	}
+	LOG4CXX_INFO(getTimeLogger(), "receiving spikes from FPGAs took " << t.get_ms() << "ms");
+}
 
-			fpga.setReceivedPulseEvents(std::move(result));
-
-			size_t const max_total_events = this->m_run_time_in_us*1e-6 * FPGA::gbitlink_max_throughput;
-			for (auto hicann : fpga.getAllocatedHICANNs()) {
-				size_t n_spikes = 0;
-				for (auto link : iter_all<GbitLinkOnHICANN>()) {
-					n_spikes += fpga.getReceivedSpikes(hicann, link).size();
-				}
-
-				double const warn_threshold = 0.9;
-				if (n_spikes >= max_total_events * warn_threshold) {
-					LOG4CXX_WARN(
-					    logger, short_format(hicann)
-					                << ": number of received spikes " << n_spikes << " close (>= "
-					                << warn_threshold * 100 << " %) to saturation of "
-					                << max_total_events << " events (given a bandwidth of "
-					                << FPGA::gbitlink_max_throughput / 1e6 << " MEvent/s)");
-				}
-			}
+void ExperimentRunner::download_spikes(FPGA& fpga, ::HMF::Handle::FPGA& handle) const
+{
+	auto logger = getLogger();
 
+	FPGA::PulseEvent::spiketime_t const duration =
+		FPGA::dnc_freq_in_MHz * this->m_run_time_in_us;
+	auto result = ::HMF::FPGA::read_trace_pulses(handle, duration);
+
+	// single pass: statistics and in-place removal of background events
+	auto const stats = ReceivedSpikeStatistics::collect(
+		result, m_drop_background_events, this->m_run_time_in_us);
+	LOG4CXX_INFO(
+		logger, "received " << stats.total
+		<< " (" << (stats.total - stats.background)
+		<< ") spikes (not background) from FPGA: " << handle.coordinate());
+
+	fpga.setReceivedPulseEvents(std::move(result));
+	fpga.setReceivedSpikeStatistics(stats);
+
+	size_t const max_total_events = this->m_run_time_in_us*1e-6 * FPGA::gbitlink_max_throughput;
+	for (auto hicann : fpga.getAllocatedHICANNs()) {
+		HICANNGlobal const hicann_global(hicann, fpga.wafer());
+		DNCOnFPGA const dnc = hicann_global.toDNCOnFPGA();
+		HICANNOnDNC const hicann_on_dnc = hicann_global.toHICANNOnDNC();
+
+		double const warn_threshold = 0.9;
+		if (stats.utilization(dnc, hicann_on_dnc) >= warn_threshold) {
+			LOG4CXX_WARN(
+			    logger, short_format(hicann)
+			                << ": number of received spikes " << stats.count(dnc, hicann_on_dnc)
+			                << " close (>= " << warn_threshold * 100 << " %) to saturation of "
+			                << max_total_events << " events (given a bandwidth of "
+			                << FPGA::gbitlink_max_throughput / 1e6 << " MEvent/s)");
 		}
 	}
-	LOG4CXX_INFO(getTimeLogger(), "receiving spikes from FPGAs took " << t.get_ms() << "ms");
 }
 
 std::ostream& operator<<(std::ostream& out, ExperimentRunner const& obj)
@@ -15,6 +15,7 @@ typedef boost::shared_ptr<log4cxx::Logger> LoggerPtr;
 #include "halco/common/typed_array.h"
 
 #include "halco/hicann/v2/external.h"
+#include "hal/FPGAContainer.h"
 
 namespace HMF {
 namespace Handle {
@@ -31,6 +32,11 @@ typedef boost::shared_ptr< ::HMF::Handle::FPGA > fpga_handle_t;
 typedef halco::common::typed_array< boost::shared_ptr<FPGA>, fpga_coord> fpga_list;
 typedef halco::common::typed_array<fpga_handle_t, fpga_coord> fpga_handle_list;
 
+/// Pulse events of each FPGA for a single run of a batch, cf. ExperimentRunner::run_batch()
+typedef halco::common::typed_array<std::vector< ::HMF::FPGA::PulseEvent>, fpga_coord>
+	fpga_pulse_events;
+typedef std::vector<fpga_pulse_events> batch_pulse_events;
+
 class ExperimentRunner
 {
 public:
@@ -39,6 +45,18 @@ public:
 
 	virtual void run(const fpga_list & fpgas, const fpga_handle_list & handles);
 
+	/**
+	 * @brief Run one experiment per entry of stimuli on an unchanged configuration.
+	 * While a run is executed on the hardware, the stimulus of the next run is
+	 * sorted and prepared for upload. The received pulse events of each run are
+	 * returned in a separate buffer, i.e. result[ii] belongs to stimuli[ii].
+	 * @note Neither sent nor received spikes stored in the FPGAs are modified.
+	 */
+	batch_pulse_events run_batch(
+	    const fpga_list & fpgas,
+	    const fpga_handle_list & handles,
+	    batch_pulse_events const& stimuli);
+
 	virtual void sort_spikes(fpga_list const& fpgas);
 	virtual void send_spikes(const fpga_list & fpgas, const fpga_handle_list & handles);
 	virtual void receive_spikes(const fpga_list & fpgas, const fpga_handle_list & handles);
@@ -54,6 +72,21 @@ public:
 
 	bool drop_background_events() const { return m_drop_background_events; }
 	void drop_background_events(bool const value) { m_drop_background_events = value; }
+
+protected:
+	/// Per-FPGA steps of the experiment run, shared by the different runners
+
+	/// reset playback memory and write the (sorted) spikes of the FPGA to it
+	void upload_spikes(FPGA& fpga, ::HMF::Handle::FPGA& handle) const;
+	void upload_spikes(
+	    FPGA const& fpga,
+	    ::HMF::Handle::FPGA& handle,
+	    ::HMF::FPGA::PulseEventContainer const& spikes) const;
+	/// wait until the FPGA reports that the playback memory has been buffered
+	void wait_for_upload(::HMF::Handle::FPGA& handle) const;
+	/// read trace memory, log statistics and store the received spikes in the FPGA
+	void download_spikes(FPGA& fpga, ::HMF::Handle::FPGA& handle) const;
+
 private:
 	double m_run_time_in_us;
 	bool m_drop_background_events;
@@ -1,24 +1,66 @@
 #include "sthal/FPGA.h"
 #include "sthal/Timer.h"
 
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/xml_iarchive.hpp>
+#include <boost/archive/xml_oarchive.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <tbb/parallel_sort.h>
+#include <log4cxx/logger.h>
+
 #include "halco/common/iter_all.h"
 #include "hal/HICANN/GbitLink.h"
 #include "hal/FPGAContainer.h"
 #include "sthal/HICANN.h"
+#include "sthal/MappedPulseEvents.h"
 
 using namespace ::halco::hicann::v2;
 using namespace ::halco::common;
 
+static log4cxx::LoggerPtr logger = log4cxx::Logger::getLogger("sthal.FPGA");
+
 namespace sthal {
 
+namespace {
+
+/// Layout of the files written by FPGA::save_spikes()
+template <typename Archiver>
+void serialize_spike_file(
+    Archiver& ar,
+    FPGAGlobal& coordinate,
+    CompactPulseEvents& send,
+    CompactPulseEvents& received,
+    CompactPulseEvents& pending)
+{
+	using boost::serialization::make_nvp;
+	ar & make_nvp("coordinate", coordinate)
+	   & make_nvp("send_pulses", send)
+	   & make_nvp("received_pulses", received)
+	   & make_nvp("pending_send_pulses", pending);
+}
+
+/// Number of pulse events copied to memory-mapped storage before they are written back
+size_t const mapping_chunk_size = 1 << 20;
+
+} // namespace
+
 const int FPGA::dnc_freq_in_MHz = ::HMF::FPGA::DNC_frequency_in_MHz;
 const double FPGA::dnc_freq = 1e6 * dnc_freq_in_MHz;
 // 1Gbit/s, 2 spikes per 80 bits
 const double FPGA::gbitlink_max_throughput = 25e6;
+constexpr size_t FPGA::n_dnc_mergers;
 
 FPGA::FPGA(fpga_coord const& fpga,
 		boost::shared_ptr<FPGAShared> shared) :
 	mCoordinate(fpga),
+	m_received_index(new ReceivedIndex),
+	m_received_mapped_size(0),
 	mSharedSettings(shared),
 	spinnaker_enable(false),
 	spinnaker_upsample_count(1),
@@ -39,10 +81,16 @@ void FPGA::addSendSpikes(const hicann_coord & hicann_local,
 		                 const dnc_merger_coord & dnc_merger,
 					     const std::vector<Spike> & pulses)
 {
-	// Invalidate cache used by #getSentSpikes()
-	m_sent_spikes_cache.clear();
+	invalidate_sent_spikes_cache();
+	append_pulse_events(hicann_local, dnc_merger, pulses, m_pending_send_pulses);
+}
 
-	std::vector<FPGA::PulseEvent>& data = m_pending_send_pulses;
+void FPGA::append_pulse_events(
+    const hicann_coord& hicann_local,
+    const dnc_merger_coord& dnc_merger,
+    const std::vector<Spike>& pulses,
+    pulse_event_container_type& data) const
+{
 	size_t old_size = data.size();
 	data.resize(old_size + pulses.size());
 
@@ -57,9 +105,83 @@ void FPGA::addSendSpikes(const hicann_coord & hicann_local,
 			);
 }
 
-void FPGA::setSendSpikes(const FPGA::PulseEventContainer & events) {
-	// Invalidate cache used by #getSentSpikes()
+void FPGA::invalidate_sent_spikes_cache()
+{
 	m_sent_spikes_cache.clear();
+}
+
+FPGA::SpikeCache::SpikeCache() : m_storage(new Storage), m_used(false)
+{
+}
+
+FPGA::SpikeCache::SpikeCache(SpikeCache const&) : SpikeCache()
+{
+}
+
+auto FPGA::SpikeCache::operator=(SpikeCache const&) -> SpikeCache&
+{
+	clear();
+	return *this;
+}
+
+void FPGA::SpikeCache::clear()
+{
+	// once flags cannot be reset, start over with fresh storage
+	if (m_used) {
+		m_storage.reset(new Storage);
+		m_used = false;
+	}
+}
+
+FPGA::SpikeBatchWriter::SpikeBatchWriter(FPGA& fpga, size_t const size_hint) : m_fpga(fpga)
+{
+	m_events.reserve(size_hint);
+}
+
+FPGA::SpikeBatchWriter::~SpikeBatchWriter()
+{
+	// roll back, e.g. when unwinding, partial batches are never handed to the FPGA
+	if (!m_events.empty()) {
+		LOG4CXX_WARN(
+			logger, "FPGA::SpikeBatchWriter: dropping " << m_events.size()
+			                                            << " uncommitted spikes");
+	}
+}
+
+void FPGA::SpikeBatchWriter::add(
+    const hicann_coord& hicann, const dnc_merger_coord& dnc_merger, const SpikeVector& pulses)
+{
+	m_fpga.append_pulse_events(hicann, dnc_merger, pulses, m_events);
+}
+
+void FPGA::SpikeBatchWriter::add(PulseEvent const& event)
+{
+	m_events.push_back(event);
+}
+
+size_t FPGA::SpikeBatchWriter::size() const
+{
+	return m_events.size();
+}
+
+void FPGA::SpikeBatchWriter::commit()
+{
+	if (m_events.empty()) {
+		return;
+	}
+
+	m_fpga.invalidate_sent_spikes_cache();
+	auto& pending = m_fpga.m_pending_send_pulses;
+	if (pending.empty()) {
+		pending.swap(m_events);
+	} else {
+		pending.insert(pending.end(), m_events.begin(), m_events.end());
+	}
+	m_events.clear();
+}
+
+void FPGA::setSendSpikes(const FPGA::PulseEventContainer & events) {
+	invalidate_sent_spikes_cache();
 	// Discard all pending unsorted pulse events, as `setSendSpikes` overwrites all events.
 	m_pending_send_pulses.clear();
 	m_send_pulses = events;
@@ -67,12 +189,30 @@ void FPGA::setSendSpikes(const FPGA::PulseEventContainer & events) {
 
 void FPGA::sortSpikes()
 {
-	m_pending_send_pulses.reserve(m_pending_send_pulses.size() + m_send_pulses.size());
-	std::copy(
-		m_send_pulses.data().begin(), m_send_pulses.data().end(),
-		std::back_inserter(m_pending_send_pulses));
-	// PulseEventContainer handles sorting.
-	m_send_pulses = PulseEventContainer(std::move(m_pending_send_pulses));
+	if (m_pending_send_pulses.empty()) {
+		return;
+	}
+
+	auto const by_time = [](PulseEvent const& a, PulseEvent const& b) {
+		return a.getTime() < b.getTime();
+	};
+
+	// Only the pending pulses are unordered, `m_send_pulses` is sorted already:
+	// sort the former and merge both in linear time.
+	tbb::parallel_sort(m_pending_send_pulses.begin(), m_pending_send_pulses.end(), by_time);
+
+	auto const& sorted = m_send_pulses.data();
+	pulse_event_container_type merged;
+	if (sorted.empty()) {
+		merged.swap(m_pending_send_pulses);
+	} else {
+		merged.resize(sorted.size() + m_pending_send_pulses.size());
+		std::merge(
+			sorted.begin(), sorted.end(), m_pending_send_pulses.begin(),
+			m_pending_send_pulses.end(), merged.begin(), by_time);
+	}
+	// `merged` is in time order, so the container does not have to reorder any event
+	m_send_pulses = PulseEventContainer(std::move(merged));
 	m_pending_send_pulses.clear();
 }
 
@@ -89,7 +229,13 @@ void FPGA::insertReceivedPulseEvent(const FPGA::PulseEvent& event) {
 	// Invalidate cache used by #getReceivedSpikes()
 	m_received_spikes.clear();
 
+	if (m_received_mapped) {
+		insert_mapped_received_pulse(event);
+		return;
+	}
+
 	m_received_pulses.push_back(event);
+	invalidate_received_index();
 }
 
 
@@ -98,73 +244,246 @@ void FPGA::setReceivedPulseEvents(pulse_event_container_type const& pulse_events
 	// Invalidate cache used by #getReceivedSpikes()
 	m_received_spikes.clear();
 
-	m_received_pulses = pulse_events;
+	m_received_mapped.reset();
+	m_received_mapped_size = 0;
+	if (!map_received_pulses(pulse_events.data(), pulse_events.data() + pulse_events.size())) {
+		m_received_pulses = pulse_events;
+	}
+	invalidate_received_index();
+	m_received_statistics = ReceivedSpikeStatistics();
 }
 
 void FPGA::setReceivedPulseEvents(pulse_event_container_type&& pulse_events)
+{
+	m_received_pulses = std::move(pulse_events);
+	adopt_received_pulses();
+	m_received_statistics = ReceivedSpikeStatistics();
+}
+
+void FPGA::adopt_received_pulses()
 {
 	// Invalidate cache used by #getReceivedSpikes()
 	m_received_spikes.clear();
 
-	m_received_pulses = std::move(pulse_events);
+	m_received_mapped.reset();
+	m_received_mapped_size = 0;
+	map_received_pulses(m_received_pulses.data(), m_received_pulses.data() + m_received_pulses.size());
+	invalidate_received_index();
 }
 
-std::vector<Spike> const& FPGA::getReceivedSpikes(
-    const hicann_coord& hicann_local, const dnc_merger_coord& dnc_merger) const
+void FPGA::adopt_received_pulses(CompactPulseEvents const& received)
 {
-	DNCMergerOnWafer const dnc_on_wafer(dnc_merger.toDNCMergerOnHICANN(), hicann_local);
-	auto const it = m_received_spikes.find(dnc_on_wafer);
-	if (it != m_received_spikes.end()) {
-		return it->second;
-	}
+	// Invalidate cache used by #getReceivedSpikes()
+	m_received_spikes.clear();
 
-	auto& spikes = m_received_spikes[dnc_on_wafer];
+	pulse_event_container_type().swap(m_received_pulses);
+	if (PulseEvent* const data = allocate_mapped_received_pulses(received.size())) {
+		received.decode(data);
+	} else {
+		received.decode(m_received_pulses);
+	}
+	invalidate_received_index();
+}
 
-	HICANNGlobal hicann(hicann_local, wafer());
-	PulseEvent::dnc_address_t  dnc(hicann.toDNCOnFPGA().value());
-	PulseEvent::chip_address_t chip(hicann.toHICANNOnDNC().toEnum());
-	PulseEvent::channel_t      merger(dnc_merger.value());
-	double t = 1.0/dnc_freq;
-	for (auto& p : m_received_pulses) {
-		if (p.matches(dnc, chip, merger)) {
-			spikes.push_back(Spike{p.getNeuronAddress(), p.getTime() * t});
-		}
+bool FPGA::map_received_pulses(PulseEvent const* const begin, PulseEvent const* const end)
+{
+	size_t const size = std::distance(begin, end);
+	PulseEvent* const data = allocate_mapped_received_pulses(size);
+	if (!data) {
+		return false;
+	}
+	// copied chunks are written back right away, so that the mapping does not add to
+	// the resident memory while the source is alive
+	for (size_t offset = 0; offset < size; offset += mapping_chunk_size) {
+		size_t const chunk_end = std::min(size, offset + mapping_chunk_size);
+		std::copy(begin + offset, begin + chunk_end, data + offset);
+		m_received_mapped->release(offset, chunk_end);
 	}
 
-	return spikes;
+	// release memory, `begin` may point into it
+	pulse_event_container_type().swap(m_received_pulses);
+	return true;
 }
 
-std::vector<Spike> const& FPGA::getSentSpikes(
-    const hicann_coord& hicann_local, const dnc_merger_coord& dnc_merger) const
+auto FPGA::allocate_mapped_received_pulses(size_t const size) -> PulseEvent*
 {
-	DNCMergerOnWafer const dnc_on_wafer(dnc_merger.toDNCMergerOnHICANN(), hicann_local);
-	auto const it = m_sent_spikes_cache.find(dnc_on_wafer);
-	if (it != m_sent_spikes_cache.end()) {
-		return it->second;
+	m_received_mapped.reset();
+	m_received_mapped_size = 0;
+	if (!mSharedSettings || mSharedSettings->getReceivedSpikesMapping().empty() || size == 0) {
+		return nullptr;
 	}
 
-	if (!m_pending_send_pulses.empty()) {
-		throw std::runtime_error("FPGA::getSentSpikes: there are spikes pending to be sent");
+	// time-ordered events followed by the events grouped by merger
+	m_received_mapped.reset(
+	    new MappedPulseEvents(mSharedSettings->getReceivedSpikesMapping(), 2 * size));
+	m_received_mapped_size = size;
+	return m_received_mapped->data();
+}
+
+void FPGA::insert_mapped_received_pulse(PulseEvent const& event)
+{
+	size_t const size = m_received_mapped_size;
+	size_t capacity = m_received_mapped->size() / 2;
+	if (size == capacity || !m_received_mapped.unique()) {
+		// copy both halves to a larger mapping, copies of this FPGA keep the old one
+		size_t const grown_capacity = std::max<size_t>(2 * size, 1);
+		boost::shared_ptr<MappedPulseEvents> grown(
+		    new MappedPulseEvents(m_received_mapped->directory(), 2 * grown_capacity));
+		PulseEvent const* const data = m_received_mapped->data();
+		std::copy(data, data + size, grown->data());
+		std::copy(data + capacity, data + capacity + size, grown->data() + grown_capacity);
+		m_received_mapped = grown;
+		capacity = grown_capacity;
 	}
 
-	auto& spikes = m_sent_spikes_cache[dnc_on_wafer];
+	m_received_mapped->data()[size] = event;
+	++m_received_mapped_size;
+	invalidate_received_index();
+}
+
+bool FPGA::hasMappedReceivedSpikes() const
+{
+	return static_cast<bool>(m_received_mapped);
+}
+
+PulseEventView FPGA::getReceivedPulseEvents() const
+{
+	if (m_received_mapped) {
+		PulseEvent const* const data = m_received_mapped->data();
+		return PulseEventView(data, data + m_received_mapped_size);
+	}
+	return PulseEventView(m_received_pulses.data(), m_received_pulses.data() + m_received_pulses.size());
+}
+
+PulseEventView FPGA::getReceivedPulseEvents(
+    const hicann_coord& hicann_local, const dnc_merger_coord& dnc_merger) const
+{
+	ReceivedIndex const& index = received_index();
+	PulseEvent const* const data = m_received_mapped
+	                                   ? m_received_mapped->data() + m_received_mapped->size() / 2
+	                                   : index.by_merger.data();
+	size_t const bucket = received_bucket(hicann_local, dnc_merger);
+	return PulseEventView(data + index.offsets[bucket], data + index.offsets[bucket + 1]);
+}
+
+auto FPGA::received_pulses_copy() const -> pulse_event_container_type
+{
+	return getReceivedPulseEvents().copy();
+}
 
+size_t FPGA::received_bucket(hicann_coord const& hicann_local, dnc_merger_coord const& dnc_merger) const
+{
 	HICANNGlobal hicann(hicann_local, wafer());
-	PulseEvent::dnc_address_t  dnc(hicann.toDNCOnFPGA().value());
-	PulseEvent::chip_address_t chip(hicann.toHICANNOnDNC().toEnum());
-	PulseEvent::channel_t      merger(dnc_merger.value());
-	double t = 1.0/dnc_freq;
-	for (auto& p : m_send_pulses.data()) {
-		if (p.matches(dnc, chip, merger)) {
-			spikes.push_back(Spike{p.getNeuronAddress(), p.getTime() * t});
+	return (hicann.toDNCOnFPGA().value() * HICANNOnDNC::enum_type::size +
+	        hicann.toHICANNOnDNC().toEnum().value()) * dnc_merger_coord::size +
+	       dnc_merger.value();
+}
+
+size_t FPGA::received_bucket(PulseEvent const& event)
+{
+	return (event.getDncAddress().value() * HICANNOnDNC::enum_type::size +
+	        event.getChipAddress().toEnum().value()) * dnc_merger_coord::size +
+	       event.getChannel().value();
+}
+
+void FPGA::invalidate_received_index()
+{
+	// an unbuilt index which is not shared with copies can be reused
+	if (m_received_index->built || m_received_index.use_count() != 1) {
+		m_received_index = std::make_shared<ReceivedIndex>();
+	}
+}
+
+auto FPGA::received_index() const -> ReceivedIndex const&
+{
+	ReceivedIndex& index = *m_received_index;
+	std::call_once(index.once, [this, &index]() {
+		PulseEventView const pulses = getReceivedPulseEvents();
+
+		// counting sort by DNC merger, stable w.r.t. the original (time) order
+		index.offsets.fill(0);
+		for (auto const& p : pulses) {
+			++index.offsets[received_bucket(p) + 1];
+		}
+		std::partial_sum(index.offsets.begin(), index.offsets.end(), index.offsets.begin());
+
+		std::array<size_t, n_dnc_mergers> next;
+		std::copy(index.offsets.begin(), index.offsets.end() - 1, next.begin());
+
+		// copies sharing the mapping share the index as well, so it is built only once
+		PulseEvent* by_merger = nullptr;
+		if (m_received_mapped) {
+			by_merger = m_received_mapped->data() + m_received_mapped->size() / 2;
+		} else {
+			index.by_merger.resize(pulses.size());
+			by_merger = index.by_merger.data();
+		}
+		for (auto const& p : pulses) {
+			by_merger[next[received_bucket(p)]++] = p;
 		}
+		if (m_received_mapped) {
+			m_received_mapped->release(0, m_received_mapped->size());
+		}
+		index.built = true;
+	});
+	return index;
+}
+
+std::vector<Spike> const& FPGA::getReceivedSpikes(
+    const hicann_coord& hicann_local, const dnc_merger_coord& dnc_merger) const
+{
+	PulseEventView const pulses = getReceivedPulseEvents(hicann_local, dnc_merger);
+	return m_received_spikes.get(
+	    received_bucket(hicann_local, dnc_merger), [&pulses](SpikeVector& spikes) {
+		    double t = 1.0/dnc_freq;
+		    spikes.reserve(pulses.size());
+		    std::transform(
+		        pulses.begin(), pulses.end(), std::back_inserter(spikes),
+		        [t](PulseEvent const& p) { return Spike{p.getNeuronAddress(), p.getTime() * t}; });
+	    });
+}
+
+SpikeTrain FPGA::getReceivedSpikeTrain(
+    const hicann_coord& hicann_local, const dnc_merger_coord& dnc_merger) const
+{
+	PulseEventView const pulses = getReceivedPulseEvents(hicann_local, dnc_merger);
+
+	SpikeTrain spikes;
+	spikes.reserve(pulses.size());
+	for (auto const& p : pulses) {
+		spikes.push_back(p.getNeuronAddress(), p.getTime());
 	}
 	return spikes;
 }
 
-auto FPGA::getReceivedSpikes() const -> pulse_event_container_type const&
+size_t FPGA::getReceivedSpikesCount(
+    const hicann_coord& hicann_local, const dnc_merger_coord& dnc_merger) const
+{
+	ReceivedIndex const& index = received_index();
+	size_t const bucket = received_bucket(hicann_local, dnc_merger);
+	return index.offsets[bucket + 1] - index.offsets[bucket];
+}
+
+std::vector<Spike> const& FPGA::getSentSpikes(
+    const hicann_coord& hicann_local, const dnc_merger_coord& dnc_merger) const
+{
+	if (!m_pending_send_pulses.empty()) {
+		throw std::runtime_error("FPGA::getSentSpikes: there are spikes pending to be sent");
+	}
+
+	// convert all sent spikes in a single pass on first access
+	return m_sent_spikes_cache.get_all(
+	    received_bucket(hicann_local, dnc_merger), [this](SpikeCache::buckets_type& buckets) {
+		    double t = 1.0/dnc_freq;
+		    for (auto const& p : m_send_pulses.data()) {
+			    buckets[received_bucket(p)].push_back(Spike{p.getNeuronAddress(), p.getTime() * t});
+		    }
+	    });
+}
+
+PulseEventView FPGA::getReceivedSpikes() const
 {
-	return m_received_pulses;
+	return getReceivedPulseEvents();
 }
 
 std::vector<FPGA::hicann_coord> FPGA::getAllocatedHICANNs() const
@@ -191,8 +510,7 @@ FPGA::fpga_coord FPGA::coordinate() const
 
 void FPGA::clearSendSpikes()
 {
-	// Invalidate cache used by #getSentSpikes()
-	m_sent_spikes_cache.clear();
+	invalidate_sent_spikes_cache();
 
 	m_send_pulses.clear();
 	m_pending_send_pulses.clear();
@@ -204,6 +522,84 @@ void FPGA::clearReceivedSpikes()
 	m_received_spikes.clear();
 
 	m_received_pulses.clear();
+	adopt_received_pulses();
+	m_received_statistics = ReceivedSpikeStatistics();
+}
+
+void FPGA::save_spikes(const char * const _filename, bool overwrite) const
+{
+	auto t = Timer::from_literal_string(__PRETTY_FUNCTION__);
+	boost::filesystem::path filename(_filename);
+	if (!overwrite && boost::filesystem::exists(filename))
+	{
+		std::string err("File '");
+		err += filename.c_str();
+		err += "' allready exists!";
+		throw std::runtime_error(err);
+	}
+
+	FPGAGlobal coordinate = mCoordinate;
+	CompactPulseEvents send(m_send_pulses.data());
+	PulseEventView const received_view = getReceivedPulseEvents();
+	CompactPulseEvents received(received_view.begin(), received_view.end());
+	CompactPulseEvents pending(m_pending_send_pulses);
+
+	boost::filesystem::ofstream stream(filename);
+	if (filename.extension() == ".xml") {
+		boost::archive::xml_oarchive ar(stream);
+		serialize_spike_file(ar, coordinate, send, received, pending);
+	} else {
+		boost::archive::binary_oarchive ar(stream);
+		serialize_spike_file(ar, coordinate, send, received, pending);
+	}
+}
+
+void FPGA::load_spikes(const char * const _filename)
+{
+	auto t = Timer::from_literal_string(__PRETTY_FUNCTION__);
+	boost::filesystem::path filename(_filename);
+	if (!boost::filesystem::exists(filename))
+	{
+		std::string err("File '");
+		err += filename.c_str();
+		err += "' not found!";
+		throw std::runtime_error(err);
+	}
+
+	FPGAGlobal coordinate;
+	CompactPulseEvents send, received, pending;
+
+	boost::filesystem::ifstream stream(filename);
+	if (filename.extension() == ".xml") {
+		boost::archive::xml_iarchive ar(stream);
+		serialize_spike_file(ar, coordinate, send, received, pending);
+	} else {
+		boost::archive::binary_iarchive ar(stream);
+		serialize_spike_file(ar, coordinate, send, received, pending);
+	}
+
+	if (coordinate != mCoordinate) {
+		std::stringstream err;
+		err << "spikes in '" << filename.c_str() << "' belong to " << coordinate
+		    << ", not to " << mCoordinate;
+		throw std::runtime_error(err.str());
+	}
+
+	clearSendSpikes();
+	m_send_pulses = PulseEventContainer(send.decode());
+	m_pending_send_pulses = pending.decode();
+	adopt_received_pulses(received);
+	m_received_statistics = ReceivedSpikeStatistics();
+}
+
+ReceivedSpikeStatistics const& FPGA::getReceivedSpikeStatistics() const
+{
+	return m_received_statistics;
+}
+
+void FPGA::setReceivedSpikeStatistics(ReceivedSpikeStatistics const& statistics)
+{
+	m_received_statistics = statistics;
 }
 
 boost::shared_ptr<FPGAShared> FPGA::commonFPGASettings()
@@ -216,6 +612,11 @@ boost::shared_ptr<const FPGAShared> FPGA::commonFPGASettings() const
 	return mSharedSettings;
 }
 
+void FPGA::setCommonFPGASettings(boost::shared_ptr<FPGAShared> const& shared)
+{
+	mSharedSettings = shared;
+}
+
 void FPGA::setSpinnakerEnable(bool const e)
 {
 	spinnaker_enable = e;
@@ -289,7 +690,10 @@ bool operator==(FPGA const& a, FPGA const& b)
 	return (a.mCoordinate == b.mCoordinate)
 		&& (a.mDNCs == b.mDNCs)
 		&& (a.m_send_pulses == b.m_send_pulses)
-		&& (a.m_received_pulses == b.m_received_pulses)
+		&& (a.getReceivedPulseEvents().size() == b.getReceivedPulseEvents().size())
+		&& std::equal(
+		       a.getReceivedPulseEvents().begin(), a.getReceivedPulseEvents().end(),
+		       b.getReceivedPulseEvents().begin())
 		&& (a.m_pending_send_pulses == b.m_pending_send_pulses)
 		&& ((static_cast<bool>(a.mSharedSettings) == static_cast<bool>(b.mSharedSettings)) &&
 			(static_cast<bool>(a.mSharedSettings) && ((*a.mSharedSettings) == (*b.mSharedSettings))))
@@ -3,11 +3,17 @@
 #include <boost/serialization/shared_ptr.hpp>
 #include <boost/serialization/set.hpp>
 #ifndef PYPLUSPLUS
-#include <unordered_map>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include "sthal/PulseEventView.h"
 #endif // !PYPLUSPLUS
 
+#include "sthal/CompactPulseEvents.h"
 #include "sthal/DNC.h"
 #include "sthal/Spike.h"
+#include "sthal/SpikeTrain.h"
+#include "sthal/ReceivedSpikeStatistics.h"
 #include "sthal/FPGAShared.h"
 #include "hal/FPGAContainer.h"
 #include "halco/hicann/v2/l1.h"
@@ -17,6 +23,7 @@
 namespace sthal {
 
 class HICANN;
+class MappedPulseEvents;
 
 class FPGA
 {
@@ -46,10 +53,57 @@ public:
 			           const dnc_merger_coord & dnc_merger,
 					   const SpikeVector & pulses);
 
+#ifndef PYPLUSPLUS
+	/**
+	 * @brief Batched alternative to many consecutive calls of #addSendSpikes().
+	 * Spikes are collected in a buffer with capacity reserved from a size hint and
+	 * handed to the FPGA in a single step by #commit(), which is also the only point
+	 * where the cache used by #getSentSpikes() is invalidated.
+	 * \code
+	 *   FPGA::SpikeBatchWriter writer(fpga, n_spikes);
+	 *   for (...) {
+	 *       writer.add(hicann, dnc_merger, spikes);
+	 *   }
+	 *   writer.commit();
+	 * \endcode
+	 * @note Spikes that have not been committed are dropped on destruction (with a
+	 *       warning), so that a batch abandoned by an exception leaves the FPGA unchanged.
+	 * @note Not exposed to python: python code hands whole spike lists to
+	 *       #addSendSpikes(), where the overhead of a call is dominated by python itself.
+	 */
+	class SpikeBatchWriter
+	{
+	public:
+		SpikeBatchWriter(FPGA& fpga, size_t size_hint = 0);
+		~SpikeBatchWriter();
+
+		SpikeBatchWriter(SpikeBatchWriter const&) = delete;
+		SpikeBatchWriter& operator=(SpikeBatchWriter const&) = delete;
+
+		void add(
+		    const hicann_coord& hicann,
+		    const dnc_merger_coord& dnc_merger,
+		    const SpikeVector& pulses);
+		void add(PulseEvent const& event);
+
+		/// number of spikes added since the last commit
+		size_t size() const;
+
+		/// append all added spikes to the pending spikes of the FPGA
+		void commit();
+
+	private:
+		FPGA& m_fpga;
+		pulse_event_container_type m_events;
+	};
+#endif // !PYPLUSPLUS
+
 	/// set the spikes that will be sent to the hardware, overwrites all existing events
 	void setSendSpikes(const PulseEventContainer & events);
 
 	/// sort Playbackmemory events ascending by time
+	/// @note Only spikes added since the last call are sorted, they are then merged
+	///       with the already sorted ones. Does nothing if no spikes have been added.
 	void sortSpikes();
 
 	/**
@@ -60,7 +114,8 @@ public:
 
 	/**
 	 * @brief Insert pulse event of received spike.
-	 * @note This invalidates the cache used by #getReceivedSpikes().
+	 * @note This invalidates the cache used by #getReceivedSpikes(). Amortized O(1),
+	 *       the per-merger index is rebuilt on the next per-merger query.
 	 */
 	void insertReceivedPulseEvent(const PulseEvent& event);
 
@@ -80,6 +135,8 @@ public:
 
 	/**
 	 * @brief Return received spikes for the given DNC merger.
+	 * @note Spikes are converted (times in seconds) and cached on first access, see
+	 *       #getReceivedPulseEvents() for a view of the pulse events without copies.
 	 */
 	SpikeVector const& getReceivedSpikes(
 	    const hicann_coord& hicann, const dnc_merger_coord& dnc_merger) const;
@@ -91,8 +148,51 @@ public:
 	SpikeVector const& getSentSpikes(
 	    const hicann_coord& hicann, const dnc_merger_coord& dnc_merger) const;
 
-	/// get received spikes
-	pulse_event_container_type const& getReceivedSpikes() const;
+	/**
+	 * @brief Return received spikes for the given DNC merger in columnar layout.
+	 * Times are not converted to seconds, see SpikeTrain.
+	 */
+	SpikeTrain getReceivedSpikeTrain(
+	    const hicann_coord& hicann, const dnc_merger_coord& dnc_merger) const;
+
+	/**
+	 * @brief Return number of received spikes for the given DNC merger.
+	 * @note This only reads the size of the corresponding bucket of the index
+	 *       built by #setReceivedPulseEvents() and does not convert any spikes.
+	 */
+	size_t getReceivedSpikesCount(
+	    const hicann_coord& hicann, const dnc_merger_coord& dnc_merger) const;
+
+	/// get received spikes, same as #getReceivedPulseEvents()
+	PulseEventView getReceivedSpikes() const;
+
+	/**
+	 * @brief View of the received pulse events in time order.
+	 * Available for in-memory and memory-mapped storage, see
+	 * FPGAShared::setReceivedSpikesMapping().
+	 * @note Invalidated by any modification of the received spikes.
+	 */
+	PulseEventView getReceivedPulseEvents() const;
+
+	/// View of the received pulse events of the given DNC merger in time order.
+	PulseEventView getReceivedPulseEvents(
+	    const hicann_coord& hicann, const dnc_merger_coord& dnc_merger) const;
+
+	/**
+	 * @brief returns true if the received pulse events are stored in a memory-mapped file
+	 * @note Pulse events handed over as a vector (#setReceivedPulseEvents()) are copied
+	 *       to the mapping in chunks, which are written back to the file right away.
+	 *       Only the vector itself is resident until it is released.
+	 */
+	bool hasMappedReceivedSpikes() const;
+
+	/**
+	 * @brief Statistics of the received trace, collected by the experiment runner
+	 * during decoding.
+	 * @note Reset by #setReceivedPulseEvents() and #clearReceivedSpikes().
+	 */
+	ReceivedSpikeStatistics const& getReceivedSpikeStatistics() const;
+	void setReceivedSpikeStatistics(ReceivedSpikeStatistics const& statistics);
 
 	std::vector<hicann_coord> getAllocatedHICANNs() const;
 
@@ -103,9 +203,40 @@ public:
 	void clearSendSpikes();
 	void clearReceivedSpikes();
 
+	/**
+	 * @brief Save sent, pending and received spikes to a file, using the compact
+	 * encoding of CompactPulseEvents. Files ending on ".xml" are written as xml,
+	 * all others as binary archive.
+	 */
+	void save_spikes(const char * const filename, bool overwrite = false) const;
+	/// Replace all spikes by the ones stored by #save_spikes()
+	void load_spikes(const char * const filename);
+
 	/// Get settings shared between all FPGAs
 	boost::shared_ptr<FPGAShared> commonFPGASettings();
 
+#ifndef PYPLUSPLUS
+	/// Replace the settings shared between all FPGAs, cf. serialize_detached
+	void setCommonFPGASettings(boost::shared_ptr<FPGAShared> const& shared);
+
+	/// (De)serializes the FPGA without its HICANNs, which have to be added again
+	/// by add_hicann() after loading. The shared settings are stored as a copy.
+	/// (cf. Wafer::dump)
+	template <typename Archiver>
+	void serialize_detached(Archiver& ar)
+	{
+		std::array<DNC, dnc_coord::size> dncs;
+		std::swap(dncs, mDNCs);
+		try {
+			ar & boost::serialization::make_nvp("fpga", *this);
+		} catch (...) {
+			std::swap(dncs, mDNCs);
+			throw;
+		}
+		std::swap(dncs, mDNCs);
+	}
+#endif // !PYPLUSPLUS
+
 #ifndef PYPLUSPLUS
 	boost::shared_ptr<const FPGAShared> commonFPGASettings() const;
 #endif
@@ -139,7 +270,7 @@ private:
 	PulseEventContainer m_send_pulses;
 	/**
 	 * @brief Yet to-be-sorted spikes that will be lazily inserted to `m_send_pulses`.
-	 * @see @sortSpikes() which merges the pending pulses into `m_send_pulses`.
+	 * @see @sortSpikes() which sorts the pending pulses and merges them into `m_send_pulses`.
 	 * This is in place as an optimization for many consecutive calls to `addSendSpikes`,
 	 * as sorting can happen after all spikes are added.  Spikes are not directly added
 	 * to `m_send_pulses`, as `PulseEventContainer` has the invariant that its contents
@@ -147,11 +278,126 @@ private:
 	 */
 	pulse_event_container_type m_pending_send_pulses;
 	pulse_event_container_type m_received_pulses;
+	ReceivedSpikeStatistics m_received_statistics;
 
 #ifndef PYPLUSPLUS
-	mutable std::unordered_map<halco::hicann::v2::DNCMergerOnWafer, SpikeVector> m_received_spikes;
-	mutable std::unordered_map<halco::hicann::v2::DNCMergerOnWafer, SpikeVector> m_sent_spikes_cache;
+	/// number of DNC mergers behind one FPGA, i.e. buckets of the received pulse index
+	static constexpr size_t n_dnc_mergers = dnc_coord::size *
+	                                        ::halco::hicann::v2::HICANNOnDNC::enum_type::size *
+	                                        dnc_merger_coord::size;
+
+	/**
+	 * @brief Received pulse events grouped by DNC merger.
+	 * Events of bucket `b` (see #received_bucket()) are stored in
+	 * `by_merger[offsets[b], offsets[b + 1])` in the same (time) order as in
+	 * `m_received_pulses` (in the second half of `m_received_mapped` if mapped).
+	 * Built in a single pass (counting sort) on the first per-merger query, guarded
+	 * by `std::call_once` so that concurrent readers of a const FPGA are safe.
+	 * Changes of the received pulses only replace it by an unbuilt index, which keeps
+	 * #insertReceivedPulseEvent() O(1). Copies share the index (and the mapping) until
+	 * either of them is modified, it is not serialized.
+	 */
+	struct ReceivedIndex
+	{
+		ReceivedIndex() : built(false) {}
+
+		std::once_flag once;
+		std::atomic<bool> built;
+		pulse_event_container_type by_merger;
+		std::array<size_t, n_dnc_mergers + 1> offsets;
+	};
+	std::shared_ptr<ReceivedIndex> m_received_index;
+
+	/**
+	 * @brief Memory-mapped storage of the received pulse events, if enabled.
+	 * Split into two halves of equal capacity: the first `m_received_mapped_size`
+	 * events of the first half are the events in time order, the ones of the second
+	 * half the events grouped by merger (see #ReceivedIndex). `m_received_pulses`
+	 * is empty then.
+	 * Copies of the FPGA share the storage, it is only modified in place if unshared.
+	 */
+	boost::shared_ptr<MappedPulseEvents> m_received_mapped;
+	size_t m_received_mapped_size;
+
+	/**
+	 * @brief Spikes converted from pulse events, per DNC merger (bucket, see #received_bucket()).
+	 * Filling is safe for concurrent readers of a const FPGA: each bucket (#get()) or
+	 * all buckets at once (#get_all()) are filled exactly once, guarded by
+	 * `std::call_once`. Invalidation (#clear()) requires exclusive access, like
+	 * any other modification of the FPGA. Copies start empty.
+	 */
+	class SpikeCache
+	{
+	public:
+		typedef std::array<SpikeVector, n_dnc_mergers> buckets_type;
+
+		SpikeCache();
+		SpikeCache(SpikeCache const&);
+		SpikeCache& operator=(SpikeCache const&);
+
+		/// drop cached spikes, cheap if nothing has been cached
+		void clear();
+
+		/// spikes of a single bucket, filled by `fill(SpikeVector&)` on first access
+		template <typename Fill>
+		SpikeVector const& get(size_t bucket, Fill const& fill) const;
+		/// spikes of a single bucket, all buckets are filled by `fill(buckets_type&)`
+		/// in one pass on first access
+		template <typename Fill>
+		SpikeVector const& get_all(size_t bucket, Fill const& fill) const;
+
+	private:
+		struct Storage
+		{
+			std::once_flag all;
+			std::array<std::once_flag, n_dnc_mergers> once;
+			buckets_type spikes;
+		};
+		std::unique_ptr<Storage> m_storage;
+		mutable std::atomic<bool> m_used;
+	};
+
+	SpikeCache m_received_spikes;
+	SpikeCache m_sent_spikes_cache;
+
+	/// per-merger index of the received pulses, built on first access
+	ReceivedIndex const& received_index() const;
 #endif // !PYPLUSPLUS
+	size_t received_bucket(hicann_coord const& hicann, dnc_merger_coord const& dnc_merger) const;
+	static size_t received_bucket(PulseEvent const& event);
+	/// marks the per-merger index of the received pulses as outdated
+	void invalidate_received_index();
+	/// takes over new contents of `m_received_pulses`: drops caches and previous
+	/// mapped storage, maps the pulses if enabled and invalidates the index
+	void adopt_received_pulses();
+	/// like adopt_received_pulses(), but decodes `received` straight into the
+	/// memory-mapped storage if enabled, without an intermediate vector
+	void adopt_received_pulses(CompactPulseEvents const& received);
+	/// moves the received pulses to memory-mapped storage if enabled in the shared settings,
+	/// returns false if they are to be kept in memory
+	bool map_received_pulses(PulseEvent const* begin, PulseEvent const* end);
+	/// replaces the memory-mapped storage by one for `size` events if enabled in the
+	/// shared settings, returns the storage of the time-ordered events or nullptr
+	PulseEvent* allocate_mapped_received_pulses(size_t size);
+	/// appends an event to the memory-mapped storage, growing it geometrically
+	void insert_mapped_received_pulse(PulseEvent const& event);
+	/// time-ordered copy of the received pulses, independent of the storage
+	pulse_event_container_type received_pulses_copy() const;
+
+	/// converts spikes to pulse events and appends them to `events`
+	void append_pulse_events(
+	    const hicann_coord& hicann,
+	    const dnc_merger_coord& dnc_merger,
+	    const SpikeVector& pulses,
+	    pulse_event_container_type& events) const;
+
+	/// Invalidate cache used by #getSentSpikes()
+	void invalidate_sent_spikes_cache();
+
+	/// spike section of the archive in the encoding of CompactPulseEvents
+	template <typename Archiver>
+	void serialize_compact_spikes(Archiver& ar);
+
 	boost::shared_ptr<FPGAShared> mSharedSettings;
 
 	/// SpiNNaker interface settings
@@ -172,10 +418,12 @@ private:
 	{
 		using boost::serialization::make_nvp;
 		ar & make_nvp("coordinate", mCoordinate)
-		   & make_nvp("dncs", mDNCs)
-		   & make_nvp("send_pulses", m_send_pulses)
-		   & make_nvp("received_pulses", m_received_pulses)
-		   & make_nvp("pending_send_pulses", m_pending_send_pulses);
+		   & make_nvp("dncs", mDNCs);
+		if (version < 6) {
+			ar & make_nvp("send_pulses", m_send_pulses)
+			   & make_nvp("received_pulses", m_received_pulses)
+			   & make_nvp("pending_send_pulses", m_pending_send_pulses);
+		}
 		if (version == 0)
 		{
 			//mSharedSettings.reset(new FPGAShared());
@@ -184,6 +432,23 @@ private:
 		{
 			ar & make_nvp("fpga_shared_settings", mSharedSettings);
 		}
+		bool compact = false;
+		if (version >= 6) {
+			// shared settings decide about the format of the spike section
+			compact = mSharedSettings && mSharedSettings->getCompactSpikeArchive();
+			if (compact) {
+				serialize_compact_spikes(ar);
+			} else if (typename Archiver::is_saving() && hasMappedReceivedSpikes()) {
+				pulse_event_container_type received = received_pulses_copy();
+				ar & make_nvp("send_pulses", m_send_pulses)
+				   & make_nvp("received_pulses", received)
+				   & make_nvp("pending_send_pulses", m_pending_send_pulses);
+			} else {
+				ar & make_nvp("send_pulses", m_send_pulses)
+				   & make_nvp("received_pulses", m_received_pulses)
+				   & make_nvp("pending_send_pulses", m_pending_send_pulses);
+			}
+		}
 		if (version >= 2) {
 			// version == 0 gets defaults by default constructor
 			ar & make_nvp("spinnaker_enable", spinnaker_enable)
@@ -197,6 +462,13 @@ private:
 		if (version >= 4) {
 			ar & make_nvp("blacklisted_hicanns", blacklisted_hicanns);
 		}
+		if (version >= 5) {
+			ar & make_nvp("received_statistics", m_received_statistics);
+		}
+		// compact spike sections are decoded straight into the received storage
+		if (typename Archiver::is_loading() && !compact) {
+			adopt_received_pulses();
+		}
 	}
 
 public:
@@ -210,9 +482,59 @@ public:
 	friend bool operator!=(FPGA const& a, FPGA const& b);
 };
 
+#ifndef PYPLUSPLUS
+template <typename Fill>
+SpikeVector const& FPGA::SpikeCache::get(size_t const bucket, Fill const& fill) const
+{
+	Storage& storage = *m_storage;
+	std::call_once(storage.once[bucket], [&]() {
+		m_used = true;
+		fill(storage.spikes[bucket]);
+	});
+	return storage.spikes[bucket];
+}
+
+template <typename Fill>
+SpikeVector const& FPGA::SpikeCache::get_all(size_t const bucket, Fill const& fill) const
+{
+	Storage& storage = *m_storage;
+	std::call_once(storage.all, [&]() {
+		m_used = true;
+		fill(storage.spikes);
+	});
+	return storage.spikes[bucket];
+}
+
+template <typename Archiver>
+void FPGA::serialize_compact_spikes(Archiver& ar)
+{
+	using boost::serialization::make_nvp;
+	if (typename Archiver::is_loading()) {
+		CompactPulseEvents send, received, pending;
+		ar & make_nvp("send_pulses", send)
+		   & make_nvp("received_pulses", received)
+		   & make_nvp("pending_send_pulses", pending);
+		m_send_pulses = PulseEventContainer(send.decode());
+		m_pending_send_pulses = pending.decode();
+		// Invalidate cache used by #getSentSpikes()
+		invalidate_sent_spikes_cache();
+		adopt_received_pulses(received);
+	} else {
+		CompactPulseEvents const send(m_send_pulses.data());
+		auto const received_view = getReceivedPulseEvents();
+		CompactPulseEvents const received(received_view.begin(), received_view.end());
+		CompactPulseEvents const pending(m_pending_send_pulses);
+		ar & make_nvp("send_pulses", send)
+		   & make_nvp("received_pulses", received)
+		   & make_nvp("pending_send_pulses", pending);
+	}
+}
+
+#endif // !PYPLUSPLUS
+
 } // end namespace sthal
 
 #include "sthal/macros_undef.h"
 
-BOOST_CLASS_VERSION(sthal::FPGA, 4)
+BOOST_CLASS_VERSION(sthal::FPGA, 6)
 BOOST_CLASS_TRACKING(sthal::FPGA, boost::serialization::track_always)
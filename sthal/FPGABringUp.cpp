@@ -0,0 +1,106 @@
+#include "sthal/FPGABringUp.h"
+
+#include <exception>
+
+extern "C" {
+#include <omp.h>
+}
+
+#include "sthal/Timer.h"
+
+namespace sthal {
+
+std::array<double, FPGABringUp::PHASES> FPGABringUp::run(size_t const n_fpgas) const
+{
+	int const n = static_cast<int>(n_fpgas);
+	std::array<double, PHASES> phase_ms{};
+
+	// first error, only accessed within the critical section inside the parallel region
+	std::exception_ptr error;
+	auto const guarded = [&error](std::function<void()> const& work) {
+		bool failed;
+		#pragma omp critical(sthal_fpga_bring_up)
+		failed = static_cast<bool>(error);
+		if (failed) {
+			return;
+		}
+		try {
+			work();
+		} catch (...) {
+			#pragma omp critical(sthal_fpga_bring_up)
+			if (!error) {
+				error = std::current_exception();
+			}
+		}
+	};
+
+	#pragma omp parallel
+	{
+		Timer phase_timer;
+		auto const finish_phase = [&phase_ms, &phase_timer](Phase const phase) {
+			#pragma omp master
+			{
+				phase_ms[phase] = phase_timer.get_ms();
+				phase_timer = Timer();
+			}
+		};
+
+		#pragma omp for schedule(dynamic)
+		for (int ii = 0; ii < n; ++ii) {
+			guarded([this, ii]() { config(ii); });
+		}
+		// implicit barrier: all FPGAs configured
+		finish_phase(CONFIG);
+
+		#pragma omp for schedule(dynamic)
+		for (int ii = 0; ii < n; ++ii) {
+			guarded([this, ii]() {
+				disable_global(ii);
+				prime_systime_counter(ii);
+			});
+		}
+		// implicit barrier: all FPGAs primed
+		finish_phase(PRIME);
+
+		#pragma omp for schedule(dynamic)
+		for (int ii = 0; ii < n; ++ii) {
+			guarded([this, ii]() { start_systime_counter(ii); });
+		}
+		finish_phase(START);
+
+		#pragma omp for schedule(dynamic)
+		for (int ii = 0; ii < n; ++ii) {
+			guarded([this, ii]() {
+				if (!is_master(ii)) {
+					disable_global(ii);
+				}
+			});
+		}
+		finish_phase(DISABLE_SLAVES);
+
+		#pragma omp for schedule(dynamic)
+		for (int ii = 0; ii < n; ++ii) {
+			guarded([this, ii]() {
+				if (is_master(ii)) {
+					disable_global(ii);
+				}
+			});
+		}
+		finish_phase(DISABLE_MASTER);
+	}
+
+	if (error) {
+		std::rethrow_exception(error);
+	}
+	return phase_ms;
+}
+
+char const* FPGABringUp::phase_name(Phase const phase)
+{
+	static char const* const names[PHASES] = {
+	    "config", "disable global/prime", "start systime", "disable global (non-master)",
+	    "disable global (master)"};
+	return names[phase];
+}
+
+} // end namespace sthal
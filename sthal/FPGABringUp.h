@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <functional>
+
+namespace sthal {
+
+/**
+ * @brief Runs the FPGA bring-up of Wafer::configure for several FPGAs in one
+ * parallel region.
+ *
+ * The steps of each FPGA are given as callbacks taking the index of the FPGA.
+ * FPGAs do not wait for each other within a phase. Barriers between the phases
+ * are required by the systime protocol:
+ *  - all FPGAs are configured before any FPGA is disabled and primed, since
+ *    configuring a single FPGA may require the systime of all FPGAs to be
+ *    restarted (cf. ParallelHICANNv4SmartConfigurator::systime_start_wanted()),
+ *  - all FPGAs have to be primed before any counter is started,
+ *  - all counters are started before global listening is disabled again,
+ *  - the master FPGA is disabled last.
+ */
+struct FPGABringUp
+{
+	enum Phase { CONFIG, PRIME, START, DISABLE_SLAVES, DISABLE_MASTER, PHASES };
+
+	typedef std::function<void(size_t fpga)> step_type;
+
+	std::function<bool(size_t fpga)> is_master;
+	/// reset and configuration of the FPGA
+	step_type config;
+	step_type disable_global;
+	step_type prime_systime_counter;
+	step_type start_systime_counter;
+
+	/**
+	 * @brief Runs all phases for FPGAs [0, n_fpgas).
+	 * After the first exception no further steps are started, it is rethrown once
+	 * all threads have left the parallel region.
+	 * @return Duration of each phase in ms.
+	 */
+	std::array<double, PHASES> run(size_t n_fpgas) const;
+
+	static char const* phase_name(Phase phase);
+};
+
+} // end namespace sthal
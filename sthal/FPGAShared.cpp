@@ -11,7 +11,8 @@ static const uint16_t fpga_hicann_delay_default = 25;
 FPGAShared::FPGAShared():
 	pll_freq(100e6),
 	fpga_hicann_delay(fpga_hicann_delay_default),
-	reset_synapse_array(false)
+	reset_synapse_array(false),
+	compact_spike_archive(false)
 {
 }
 
@@ -55,11 +56,32 @@ bool FPGAShared::getSynapseArrayReset() const
 	return reset_synapse_array;
 }
 
+void FPGAShared::setCompactSpikeArchive(bool compact)
+{
+	compact_spike_archive = compact;
+}
+
+bool FPGAShared::getCompactSpikeArchive() const
+{
+	return compact_spike_archive;
+}
+
+void FPGAShared::setReceivedSpikesMapping(std::string const& directory)
+{
+	received_spikes_mapping = directory;
+}
+
+std::string const& FPGAShared::getReceivedSpikesMapping() const
+{
+	return received_spikes_mapping;
+}
+
 bool operator==(const FPGAShared & a, const FPGAShared & b)
 {
 	return (a.pll_freq          == b.pll_freq)
 		&& (a.fpga_hicann_delay == b.fpga_hicann_delay)
 		&& (a.reset_synapse_array == b.reset_synapse_array)
+		&& (a.compact_spike_archive == b.compact_spike_archive)
 	;
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <string>
 #include <boost/serialization/nvp.hpp>
 #include <boost/serialization/version.hpp>
 
@@ -30,6 +31,21 @@ public:
 	void setSynapseArrayReset(bool reset);
 	bool getSynapseArrayReset() const;
 
+	/// store spikes of the FPGAs in archives in a compact delta/varint encoding,
+	/// see CompactPulseEvents
+	void setCompactSpikeArchive(bool compact);
+	bool getCompactSpikeArchive() const;
+
+	/// store received pulse events in memory-mapped files in the given directory
+	/// instead of main memory, an empty string disables the mapping (default)
+	/// @note this is a runtime option and not part of archives
+	/// @note Traces handed over as a vector are held twice while being copied to the
+	///       mapping, see FPGA::hasMappedReceivedSpikes(). Only FPGA::load_spikes() and
+	///       FPGA::insertReceivedPulseEvent() write to the mapping directly. Saving
+	///       archives without compact spike encoding copies the mapped trace to memory.
+	void setReceivedSpikesMapping(std::string const& directory);
+	std::string const& getReceivedSpikesMapping() const;
+
 	friend bool operator==(const FPGAShared & a, const FPGAShared & b);
 	friend bool operator!=(const FPGAShared & a, const FPGAShared & b);
 
@@ -43,6 +59,12 @@ private:
 	/// Reset synapse array during FPGA init
 	bool reset_synapse_array;
 
+	/// Use CompactPulseEvents for spikes in archives
+	bool compact_spike_archive;
+
+	/// Directory for memory-mapped received pulse events, not serialized
+	std::string received_spikes_mapping;
+
 	friend class boost::serialization::access;
 	template<typename Archiver>
 	void serialize(Archiver & ar, unsigned int const version)
@@ -53,9 +75,12 @@ private:
 		if (version >= 1) {
 			ar & make_nvp("reset_synapse_array", reset_synapse_array);
 		}
+		if (version >= 2) {
+			ar & make_nvp("compact_spike_archive", compact_spike_archive);
+		}
 	}
 };
 
 } // end namespace sthal
 
-BOOST_CLASS_VERSION(sthal::FPGAShared, 1)
+BOOST_CLASS_VERSION(sthal::FPGAShared, 2)
@@ -31,6 +31,41 @@ namespace sthal {
 		return *this;
 	}
 
+	size_t const FloatingGates::packed_bits;
+
+	size_t FloatingGates::packed_bytes()
+	{
+		return packed_size(FGBlockOnHICANN::size * FGCellOnFGBlock::enum_type::size, packed_bits);
+	}
+
+	std::vector<uint8_t> FloatingGates::pack() const
+	{
+		std::vector<uint8_t> data(packed_bytes(), 0);
+		size_t index = 0;
+		for (auto block : iter_all<FGBlockOnHICANN>())
+		{
+			::HMF::HICANN::FGBlock const& fg_block = (*this)[block];
+			for (auto cell : iter_all<FGCellOnFGBlock>())
+			{
+				pack_bits(data, packed_bits, index++, fg_block.getRaw(cell));
+			}
+		}
+		return data;
+	}
+
+	void FloatingGates::unpack(std::vector<uint8_t> const& data)
+	{
+		size_t index = 0;
+		for (auto block : iter_all<FGBlockOnHICANN>())
+		{
+			::HMF::HICANN::FGBlock& fg_block = (*this)[block];
+			for (auto cell : iter_all<FGCellOnFGBlock>())
+			{
+				fg_block.setRaw(cell, unpack_bits(data, packed_bits, index++));
+			}
+		}
+	}
+
 	bool operator== (FloatingGates const& a, FloatingGates const& b)
 	{
 		return static_cast< const ::HMF::HICANN::FGControl & >(a) ==
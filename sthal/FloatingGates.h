@@ -1,11 +1,13 @@
 #pragma once
 
+#include <boost/serialization/binary_object.hpp>
 #include <boost/serialization/vector.hpp>
 
 #include "hal/HICANN/FGControl.h"
 #include "hal/HICANN/FGStimulus.h"
 
 #include "sthal/FGConfig.h"
+#include "sthal/PackedSerialization.h"
 
 namespace sthal {
 
@@ -36,12 +38,33 @@ public:
 private:
 	std::vector<FGConfig> mFGConfigs;
 
+	/// FG cell values packed as 10 bit values, cf. serialize()
+	static size_t const packed_bits = 10;
+	static size_t packed_bytes();
+	std::vector<uint8_t> pack() const;
+	void unpack(std::vector<uint8_t> const& data);
+
 	friend class boost::serialization::access;
 	template<typename Archiver>
 	void serialize(Archiver & ar, unsigned int const version)
 	{
 		using namespace boost::serialization;
-		ar & make_nvp("base", base_object< ::HMF::HICANN::FGControl >(*this));
+		if (version >= 2 && is_packed_archive<Archiver>::value) {
+			// binary archives store the cell values of all blocks as one packed block
+			std::vector<uint8_t> data;
+			if (!Archiver::is_loading::value) {
+				data = pack();
+			} else {
+				data.resize(packed_bytes());
+			}
+			auto binary = make_binary_object(data.data(), data.size());
+			ar & make_nvp("packed", binary);
+			if (Archiver::is_loading::value) {
+				unpack(data);
+			}
+		} else {
+			ar & make_nvp("base", base_object< ::HMF::HICANN::FGControl >(*this));
+		}
 		if (version < 1)
 		{
 			// TODO best I can do without making it terrible complicated
@@ -56,4 +79,4 @@ private:
 
 } // end namespace sthal
 
-BOOST_CLASS_VERSION(::sthal::FloatingGates, 1)
+BOOST_CLASS_VERSION(::sthal::FloatingGates, 2)
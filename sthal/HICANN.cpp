@@ -1,8 +1,11 @@
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
 #include <boost/archive/xml_oarchive.hpp>
 #include <boost/archive/xml_iarchive.hpp>
 #include <boost/serialization/weak_ptr.hpp>
+#include <boost/make_shared.hpp>
 
 #include "sthal/HICANN.h"
 #include "sthal/FPGA.h"
@@ -276,6 +279,11 @@ SpikeVector HICANN::sentSpikes(const dnc_merger_coord & link) const
 	return fpga()->getSentSpikes(mCoordinate, link);
 }
 
+boost::shared_ptr<SpikeTrain> HICANN::receivedSpikeTrain(const dnc_merger_coord & link) const
+{
+	return boost::make_shared<SpikeTrain>(fpga()->getReceivedSpikeTrain(mCoordinate, link));
+}
+
 void HICANN::setCurrentStimulus(const neuron_coord & ii, const FGStimulus & stim)
 {
 	FGBlockOnHICANN fg_block = ii.toSharedFGBlockOnHICANN();
@@ -878,6 +886,24 @@ void HICANN::serialize(Archiver& ar, unsigned int const)
 	   & make_nvp("mMinorVersion", mMinorVersion);
 }
 
+template <typename Archiver>
+void HICANN::serialize_detached(Archiver& ar)
+{
+	using namespace boost::serialization;
+	ar & make_nvp("base", base_object<HICANNData>(*this))
+	   & make_nvp("coordinate", mCoordinate)
+	   & make_nvp("mVersion", mVersion)
+	   & make_nvp("mMinorVersion", mMinorVersion);
+}
+
+template void HICANN::serialize_detached(boost::archive::binary_oarchive&);
+template void HICANN::serialize_detached(boost::archive::binary_iarchive&);
+
+void HICANN::attach(boost::shared_ptr<FPGA> const& fpga, Wafer* wafer)
+{
+	mFPGA = fpga;
+	mWafer = wafer;
+}
 
 } // end namespace sthal
 
@@ -11,6 +11,7 @@
 #include "sthal/AnalogRecorder.h"
 #include "sthal/HICANNData.h"
 #include "sthal/Spike.h"
+#include "sthal/SpikeTrain.h"
 #include "sthal/ADCConfig.h"
 #include "sthal/SpeedUp.h"
 
@@ -172,6 +173,10 @@ public:
 	std::vector<Spike> receivedSpikes(const dnc_merger_coord & link) const;
 	std::vector<Spike> sentSpikes(const dnc_merger_coord & link) const;
 
+	/// Received spikes in columnar layout, in python `times` and `addrs` of the
+	/// result can be used as numpy arrays without copying
+	boost::shared_ptr<SpikeTrain> receivedSpikeTrain(const dnc_merger_coord & link) const;
+
 	// TODO: check that at least one repeater send 0 to each used mergertree output
 	// void check_repeater_locking();
 
@@ -233,6 +238,16 @@ public:
 	/// check if HICANN knows its wafer
 	bool has_wafer() const;
 
+#ifndef PYPLUSPLUS
+	/// (De)serializes the HICANN without its links to FPGA and wafer, which have to
+	/// be restored by attach() after loading (cf. Wafer::dump)
+	template <typename Archiver>
+	void serialize_detached(Archiver& ar);
+
+	/// Links the HICANN to its FPGA and wafer
+	void attach(boost::shared_ptr<FPGA> const& fpga, Wafer* wafer);
+#endif // !PYPLUSPLUS
+
 private:
 	hicann_coord mCoordinate;
 	boost::weak_ptr<FPGA> mFPGA;
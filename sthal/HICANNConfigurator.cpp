@@ -361,12 +361,14 @@ void HICANNConfigurator::config_synapse_drivers(
 	auto t = Timer::from_literal_string(__PRETTY_FUNCTION__);
 	LOG4CXX_DEBUG(getLogger(), short_format(h->coordinate())
 	                               << ": configure synapse drivers");
+	// const access, mutable access is tracked as modification
+	SynapseArray const& synapses = hicann->synapses;
 	for (auto syndrv : iter_all<SynapseDriverOnHICANN>()) {
 		::HMF::HICANN::set_synapse_driver(
 		    *h,
 		    static_cast< ::HMF::HICANN::SynapseController>(
 		        hicann->synapse_controllers[syndrv.toSynapseArrayOnHICANN()]),
-		    syndrv, hicann->synapses[syndrv]);
+		    syndrv, synapses[syndrv]);
 	}
 	LOG4CXX_DEBUG(getTimeLogger(), short_format(h->coordinate())
 	                                   << ": configure synapse drivers took "
@@ -408,17 +410,19 @@ void HICANNConfigurator::config_synapse_array(hicann_handle_t const& h,
                                               hicann_data_t const& hicann) {
 	auto t = Timer::from_literal_string(__PRETTY_FUNCTION__);
 	LOG4CXX_DEBUG(getLogger(), short_format(h->coordinate()) << ": configure synapses");
+	// const access, mutable access is tracked as modification
+	SynapseArray const& synapses = hicann->synapses;
 	for (auto syndrv : iter_all<SynapseDriverOnHICANN>()) {
 		::HMF::HICANN::SynapseController const synapse_controller =
 		    static_cast<HMF::HICANN::SynapseController>(
 		        hicann->synapse_controllers[syndrv.toSynapseArrayOnHICANN()]);
 		::HMF::HICANN::set_decoder_double_row(
-		    *h, synapse_controller, syndrv, hicann->synapses.getDecoderDoubleRow(syndrv));
+		    *h, synapse_controller, syndrv, synapses.getDecoderDoubleRow(syndrv));
 
 		for (auto side : iter_all<SideVertical>()) {
 			SynapseRowOnHICANN row(syndrv, RowOnSynapseDriver(side));
-			LOG4CXX_TRACE(getLogger(), format_debug(row, hicann->synapses[row].weights));
-			::HMF::HICANN::set_weights_row(*h, synapse_controller, row, hicann->synapses[row].weights);
+			LOG4CXX_TRACE(getLogger(), format_debug(row, synapses[row].weights));
+			::HMF::HICANN::set_weights_row(*h, synapse_controller, row, synapses[row].weights);
 		}
 	}
 	LOG4CXX_DEBUG(getTimeLogger(), short_format(h->coordinate())
@@ -0,0 +1,220 @@
+#include "sthal/HICANNDataDelta.h"
+
+#include <stdexcept>
+
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/optional.hpp>
+#include <boost/serialization/utility.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/version.hpp>
+#include <log4cxx/logger.h>
+
+#include "halco/common/iter_all.h"
+#include "sthal/ContentHash.h"
+
+using namespace ::halco::hicann::v2;
+using namespace ::halco::common;
+
+static log4cxx::LoggerPtr logger = log4cxx::Logger::getLogger("sthal.HICANNDataDelta");
+
+namespace sthal {
+
+namespace {
+
+/// Version of the algorithm behind HICANNDataDelta::base_hash(), i.e. content_hash()
+/// of the whole HICANNData. Has to be bumped if the hash changes for other reasons
+/// than a class version, e.g. a modified content_hash().
+uint64_t const base_hash_algorithm = 1;
+
+template <typename T>
+uint64_t with_class_version(uint64_t const seed)
+{
+	return hash_combine(seed, boost::serialization::version<T>::value);
+}
+
+template <typename T>
+void store_if_changed(boost::optional<T>& delta, T const& base, T const& data)
+{
+	if (base != data) {
+		delta = data;
+	}
+}
+
+template <typename T>
+void apply_if_stored(boost::optional<T> const& delta, T& data)
+{
+	if (delta) {
+		data = *delta;
+	}
+}
+
+/// Changed FG blocks, empty if more than the blocks changed
+std::vector<std::pair<uint32_t, ::HMF::HICANN::FGBlock> > fg_block_changes(
+	FloatingGates const& base, FloatingGates const& data, bool& complete)
+{
+	std::vector<std::pair<uint32_t, ::HMF::HICANN::FGBlock> > changes;
+	FloatingGates patched = base;
+	for (auto block : iter_all<FGBlockOnHICANN>()) {
+		if (base[block] != data[block]) {
+			changes.emplace_back(block.toEnum().value(), data[block]);
+			patched[block] = data[block];
+		}
+	}
+	complete = (patched == data);
+	return changes;
+}
+
+} // anonymous namespace
+
+HICANNDataDelta::HICANNDataDelta() : m_base_hash(0), m_base_hash_layout(0) {}
+
+HICANNDataDelta::HICANNDataDelta(HICANNData const& base, HICANNData const& data) :
+	m_base_hash(content_hash(base)),
+	m_base_hash_layout(current_base_hash_layout())
+{
+	if (base.floating_gates != data.floating_gates) {
+		bool complete = false;
+		m_fg_blocks = fg_block_changes(base.floating_gates, data.floating_gates, complete);
+		if (!complete) {
+			m_fg_blocks.clear();
+			m_floating_gates = data.floating_gates;
+		}
+	}
+
+	if (base.synapses != data.synapses) {
+		SynapseArray const& base_synapses = base.synapses;
+		SynapseArray const& synapses = data.synapses;
+		for (auto driver : iter_all<SynapseDriverOnHICANN>()) {
+			uint32_t const id = driver.toEnum().value();
+			if (base_synapses[driver] != synapses[driver]) {
+				m_synapse_drivers.emplace_back(id, synapses[driver]);
+			}
+			if (base_synapses.getDecoderDoubleRow(driver) != synapses.getDecoderDoubleRow(driver)) {
+				m_synapse_decoders.emplace_back(id, synapses.getDecoderDoubleRow(driver));
+			}
+		}
+		for (auto row : iter_all<SynapseRowOnHICANN>()) {
+			if (base_synapses[row].weights != synapses[row].weights) {
+				m_synapse_weights.emplace_back(row.toEnum().value(), synapses[row].weights);
+			}
+		}
+	}
+
+	store_if_changed(m_analog, base.analog, data.analog);
+	store_if_changed(m_repeater, base.repeater, data.repeater);
+	store_if_changed(m_neurons, base.neurons, data.neurons);
+	store_if_changed(m_layer1, base.layer1, data.layer1);
+	store_if_changed(m_synapse_controllers, base.synapse_controllers, data.synapse_controllers);
+	store_if_changed(m_synapse_switches, base.synapse_switches, data.synapse_switches);
+	store_if_changed(m_crossbar_switches, base.crossbar_switches, data.crossbar_switches);
+	store_if_changed(m_current_stimuli, base.current_stimuli, data.current_stimuli);
+}
+
+bool HICANNDataDelta::empty() const
+{
+	return !m_floating_gates && m_fg_blocks.empty() && !m_analog && !m_repeater &&
+	       m_synapse_drivers.empty() && m_synapse_decoders.empty() &&
+	       m_synapse_weights.empty() && !m_neurons && !m_layer1 && !m_synapse_controllers &&
+	       !m_synapse_switches && !m_crossbar_switches && !m_current_stimuli;
+}
+
+uint64_t HICANNDataDelta::base_hash() const
+{
+	return m_base_hash;
+}
+
+uint64_t HICANNDataDelta::base_hash_layout() const
+{
+	return m_base_hash_layout;
+}
+
+uint64_t HICANNDataDelta::current_base_hash_layout()
+{
+	uint64_t layout = base_hash_algorithm;
+	layout = with_class_version<HICANNData>(layout);
+	layout = with_class_version<FloatingGates>(layout);
+	layout = with_class_version<AnalogOutput>(layout);
+	layout = with_class_version<L1Repeaters>(layout);
+	layout = with_class_version<SynapseArray>(layout);
+	layout = with_class_version<Neurons>(layout);
+	layout = with_class_version<Layer1>(layout);
+	layout = with_class_version<SynapseControllers>(layout);
+	layout = with_class_version<SynapseSwitches>(layout);
+	layout = with_class_version<CrossbarSwitches>(layout);
+	layout = with_class_version<FGStimulus>(layout);
+	// 0 marks deltas without recorded layout
+	return layout ? layout : 1;
+}
+
+void HICANNDataDelta::apply(HICANNData& base, bool const strict) const
+{
+	if (m_base_hash_layout == current_base_hash_layout()) {
+		if (content_hash(base) != m_base_hash) {
+			if (strict) {
+				throw std::invalid_argument(
+					"HICANNDataDelta::apply(): configuration differs from the base of the delta");
+			}
+			LOG4CXX_WARN(
+				logger, "HICANNDataDelta::apply(): content hash differs from the base of the "
+				        "delta, either the configuration or its archive representation differs");
+		}
+	} else {
+		LOG4CXX_WARN(
+			logger, "HICANNDataDelta::apply(): delta was written with another archive layout, "
+			        "its base can not be verified");
+	}
+
+	apply_if_stored(m_floating_gates, base.floating_gates);
+	for (auto const& block : m_fg_blocks) {
+		base.floating_gates[FGBlockOnHICANN(Enum(block.first))] = block.second;
+	}
+
+	for (auto const& driver : m_synapse_drivers) {
+		base.synapses[SynapseDriverOnHICANN(Enum(driver.first))] = driver.second;
+	}
+	for (auto const& decoder : m_synapse_decoders) {
+		base.synapses.setDecoderDoubleRow(SynapseDriverOnHICANN(Enum(decoder.first)), decoder.second);
+	}
+	for (auto const& weights : m_synapse_weights) {
+		base.synapses[SynapseRowOnHICANN(Enum(weights.first))].weights = weights.second;
+	}
+
+	apply_if_stored(m_analog, base.analog);
+	apply_if_stored(m_repeater, base.repeater);
+	apply_if_stored(m_neurons, base.neurons);
+	apply_if_stored(m_layer1, base.layer1);
+	apply_if_stored(m_synapse_controllers, base.synapse_controllers);
+	apply_if_stored(m_synapse_switches, base.synapse_switches);
+	apply_if_stored(m_crossbar_switches, base.crossbar_switches);
+	apply_if_stored(m_current_stimuli, base.current_stimuli);
+}
+
+template<typename Archiver>
+void HICANNDataDelta::serialize(Archiver & ar, unsigned int const version)
+{
+	using boost::serialization::make_nvp;
+	ar & make_nvp("base_hash", m_base_hash);
+	if (version >= 1) {
+		ar & make_nvp("base_hash_layout", m_base_hash_layout);
+	} else {
+		m_base_hash_layout = 0;
+	}
+	ar & make_nvp("floating_gates", m_floating_gates)
+	   & make_nvp("fg_blocks", m_fg_blocks)
+	   & make_nvp("analog", m_analog)
+	   & make_nvp("repeater", m_repeater)
+	   & make_nvp("synapse_drivers", m_synapse_drivers)
+	   & make_nvp("synapse_decoders", m_synapse_decoders)
+	   & make_nvp("synapse_weights", m_synapse_weights)
+	   & make_nvp("neurons", m_neurons)
+	   & make_nvp("layer1", m_layer1)
+	   & make_nvp("synapse_controllers", m_synapse_controllers)
+	   & make_nvp("synapse_switches", m_synapse_switches)
+	   & make_nvp("crossbar_switches", m_crossbar_switches)
+	   & make_nvp("current_stimuli", m_current_stimuli);
+}
+
+} // end namespace sthal
+
+#include "boost/serialization/serialization_helper.tcc"
+EXPLICIT_INSTANTIATE_BOOST_SERIALIZE(sthal::HICANNDataDelta)
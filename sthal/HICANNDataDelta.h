@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <boost/optional.hpp>
+#include <boost/serialization/version.hpp>
+
+#include "sthal/HICANNData.h"
+
+namespace sthal {
+
+/// Difference of a HICANN configuration to a base configuration, as stored by
+/// Wafer::dump_delta.
+///
+/// Blocks are compared like the smart configurator does. Changed blocks are stored
+/// as a whole, except for synapses (changed drivers, decoder double rows and weight
+/// rows) and floating gates (changed FG blocks, or all floating gates if e.g. the
+/// programming passes changed).
+class HICANNDataDelta
+{
+public:
+	HICANNDataDelta();
+
+	/// Difference of data to base
+	HICANNDataDelta(HICANNData const& base, HICANNData const& data);
+
+	/// Whether data and base were equal
+	bool empty() const;
+
+	/// content hash of the base configuration, cf. content_hash()
+	uint64_t base_hash() const;
+
+	/// Identifies how base_hash() was computed: the version of the hash algorithm
+	/// combined with the class versions of HICANNData and its blocks. Content hashes
+	/// depend on the archive layout, so base hashes of deltas written with another
+	/// layout can not be compared. 0 for deltas written before it was recorded.
+	/// @note Layout changes of halbe types nested in the blocks are not covered.
+	uint64_t base_hash_layout() const;
+	/// base_hash_layout() of deltas taken by this build
+	static uint64_t current_base_hash_layout();
+
+	/// Turns base into the configuration the delta was taken of. The base is only
+	/// verified if the delta was written with the current base_hash_layout(), other
+	/// deltas are applied unverified with a warning.
+	/// Content hashes depend on the binary archive representation, which is not
+	/// guaranteed to be stable across builds and platforms (e.g. layout changes of
+	/// nested halbe types, type sizes). A mismatch is therefore only reported as a
+	/// warning, unless strict verification is requested.
+	/// @param strict throw if base differs from the base of the delta
+	/// @throw std::invalid_argument if strict and base differs from the base of the delta
+	void apply(HICANNData& base, bool strict = false) const;
+
+private:
+	template <typename T>
+	using row_changes_t = std::vector<std::pair<uint32_t, T> >;
+
+	uint64_t m_base_hash;
+	uint64_t m_base_hash_layout;
+
+	boost::optional<FloatingGates> m_floating_gates;
+	row_changes_t< ::HMF::HICANN::FGBlock> m_fg_blocks;
+	boost::optional<AnalogOutput> m_analog;
+	boost::optional<L1Repeaters> m_repeater;
+	row_changes_t<SynapseArray::driver_type> m_synapse_drivers;
+	row_changes_t< ::HMF::HICANN::DecoderDoubleRow> m_synapse_decoders;
+	row_changes_t<SynapseArray::weight_row_type> m_synapse_weights;
+	boost::optional<Neurons> m_neurons;
+	boost::optional<Layer1> m_layer1;
+	boost::optional<SynapseControllers> m_synapse_controllers;
+	boost::optional<SynapseSwitches> m_synapse_switches;
+	boost::optional<CrossbarSwitches> m_crossbar_switches;
+	boost::optional<decltype(HICANNData::current_stimuli)> m_current_stimuli;
+
+	friend class boost::serialization::access;
+	template<typename Archiver>
+	void serialize(Archiver & ar, unsigned int const version);
+};
+
+} // end namespace sthal
+
+BOOST_CLASS_VERSION(sthal::HICANNDataDelta, 1)
@@ -0,0 +1,211 @@
+#include "sthal/HICANNDataSnapshot.h"
+
+#include <boost/make_shared.hpp>
+#include <boost/serialization/nvp.hpp>
+
+#include "halco/common/iter_all.h"
+#include "sthal/ContentHash.h"
+
+namespace sthal {
+
+namespace {
+
+template <typename Block, typename T>
+Block share_or_copy(T const& current, Block const& previous, size_t& shared)
+{
+	if (previous.data && *previous.data == current) {
+		++shared;
+		return previous;
+	}
+	return Block{boost::shared_ptr<T const>(boost::make_shared<T>(current)),
+	             content_hash(current)};
+}
+
+bool same_drivers(SynapseArray const& a, SynapseArray const& b)
+{
+	for (auto const& driver : halco::common::iter_all<SynapseArray::driver_coordinate>()) {
+		if (a[driver] != b[driver]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// blocks are stored by value, restored blocks are not shared
+template <typename Archiver, typename Block>
+void serialize_block(Archiver& ar, char const* name, Block& block)
+{
+	using boost::serialization::make_nvp;
+	typedef typename Block::value_type T;
+	if (Archiver::is_saving::value) {
+		ar & make_nvp(name, const_cast<T&>(*block.data));
+	} else {
+		auto loaded = boost::make_shared<T>();
+		ar & make_nvp(name, *loaded);
+		block.data = loaded;
+		block.hash = content_hash(*loaded);
+	}
+}
+
+} // anonymous namespace
+
+HICANNDataSnapshot::HICANNDataSnapshot() :
+	m_synapse_generation(0, 0),
+	m_shared_blocks(0),
+	m_content_hash(0)
+{}
+
+HICANNDataSnapshot::HICANNDataSnapshot(
+	HICANNData const& hicann, HICANNDataSnapshot const* previous) :
+	m_current_stimuli(hicann.current_stimuli),
+	m_synapse_generation(hicann.synapses.history(), hicann.synapses.generation()),
+	m_shared_blocks(0)
+{
+	HICANNDataSnapshot const empty;
+	HICANNDataSnapshot const& prev = previous ? *previous : empty;
+
+	m_floating_gates = share_or_copy(hicann.floating_gates, prev.m_floating_gates, m_shared_blocks);
+	m_analog = share_or_copy(hicann.analog, prev.m_analog, m_shared_blocks);
+	m_repeater = share_or_copy(hicann.repeater, prev.m_repeater, m_shared_blocks);
+	m_neurons = share_or_copy(hicann.neurons, prev.m_neurons, m_shared_blocks);
+	m_layer1 = share_or_copy(hicann.layer1, prev.m_layer1, m_shared_blocks);
+	m_synapse_controllers =
+		share_or_copy(hicann.synapse_controllers, prev.m_synapse_controllers, m_shared_blocks);
+	m_synapse_switches =
+		share_or_copy(hicann.synapse_switches, prev.m_synapse_switches, m_shared_blocks);
+	m_crossbar_switches =
+		share_or_copy(hicann.crossbar_switches, prev.m_crossbar_switches, m_shared_blocks);
+
+	// the synapse array is by far the largest block, avoid comparing it if it has not
+	// been modified since the previous snapshot. References to drivers are not
+	// tracked (cf. SynapseArray::generation()), so the drivers are always compared.
+	if (prev.m_synapses.data && prev.m_synapse_generation.first != 0 &&
+	    prev.m_synapse_generation == m_synapse_generation &&
+	    same_drivers(*prev.m_synapses.data, hicann.synapses)) {
+		m_synapses = prev.m_synapses;
+		++m_shared_blocks;
+	} else {
+		m_synapses = share_or_copy(hicann.synapses, prev.m_synapses, m_shared_blocks);
+	}
+
+	update_content_hash();
+}
+
+void HICANNDataSnapshot::update_content_hash()
+{
+	// qualified, the member content_hash() hides the free function
+	uint64_t hash = sthal::content_hash(m_current_stimuli);
+	for (uint64_t const block_hash :
+	     {m_floating_gates.hash, m_analog.hash, m_repeater.hash, m_synapses.hash,
+	      m_neurons.hash, m_layer1.hash, m_synapse_controllers.hash, m_synapse_switches.hash,
+	      m_crossbar_switches.hash}) {
+		hash = hash_combine(hash, block_hash);
+	}
+	m_content_hash = hash;
+}
+
+FloatingGates const& HICANNDataSnapshot::floating_gates() const
+{
+	return *m_floating_gates.data;
+}
+
+AnalogOutput const& HICANNDataSnapshot::analog() const
+{
+	return *m_analog.data;
+}
+
+L1Repeaters const& HICANNDataSnapshot::repeater() const
+{
+	return *m_repeater.data;
+}
+
+SynapseArray const& HICANNDataSnapshot::synapses() const
+{
+	return *m_synapses.data;
+}
+
+Neurons const& HICANNDataSnapshot::neurons() const
+{
+	return *m_neurons.data;
+}
+
+Layer1 const& HICANNDataSnapshot::layer1() const
+{
+	return *m_layer1.data;
+}
+
+SynapseControllers const& HICANNDataSnapshot::synapse_controllers() const
+{
+	return *m_synapse_controllers.data;
+}
+
+SynapseSwitches const& HICANNDataSnapshot::synapse_switches() const
+{
+	return *m_synapse_switches.data;
+}
+
+CrossbarSwitches const& HICANNDataSnapshot::crossbar_switches() const
+{
+	return *m_crossbar_switches.data;
+}
+
+HICANNDataSnapshot::synapse_generation_t HICANNDataSnapshot::synapse_generation() const
+{
+	return m_synapse_generation;
+}
+
+size_t HICANNDataSnapshot::shared_blocks() const
+{
+	return m_shared_blocks;
+}
+
+uint64_t HICANNDataSnapshot::synapses_hash() const
+{
+	return m_synapses.hash;
+}
+
+uint64_t HICANNDataSnapshot::content_hash() const
+{
+	return m_content_hash;
+}
+
+void HICANNDataSnapshot::copy_to(HICANNData& hicann) const
+{
+	hicann.floating_gates = *m_floating_gates.data;
+	hicann.analog = *m_analog.data;
+	hicann.repeater = *m_repeater.data;
+	hicann.synapses = *m_synapses.data;
+	hicann.neurons = *m_neurons.data;
+	hicann.layer1 = *m_layer1.data;
+	hicann.synapse_controllers = *m_synapse_controllers.data;
+	hicann.synapse_switches = *m_synapse_switches.data;
+	hicann.crossbar_switches = *m_crossbar_switches.data;
+	hicann.current_stimuli = m_current_stimuli;
+}
+
+template<typename Archiver>
+void HICANNDataSnapshot::serialize(Archiver & ar, unsigned int const)
+{
+	using namespace boost::serialization;
+	serialize_block(ar, "floating_gates", m_floating_gates);
+	serialize_block(ar, "analog", m_analog);
+	serialize_block(ar, "repeater", m_repeater);
+	serialize_block(ar, "synapses", m_synapses);
+	serialize_block(ar, "neurons", m_neurons);
+	serialize_block(ar, "layer1", m_layer1);
+	serialize_block(ar, "synapse_controllers", m_synapse_controllers);
+	serialize_block(ar, "synapse_switches", m_synapse_switches);
+	serialize_block(ar, "crossbar_switches", m_crossbar_switches);
+	ar & make_nvp("current_stimuli", m_current_stimuli);
+	if (Archiver::is_loading::value) {
+		// the history of the original synapse array is unknown
+		m_synapse_generation = synapse_generation_t(0, 0);
+		m_shared_blocks = 0;
+		update_content_hash();
+	}
+}
+
+} // end namespace sthal
+
+#include "boost/serialization/serialization_helper.tcc"
+EXPLICIT_INSTANTIATE_BOOST_SERIALIZE(sthal::HICANNDataSnapshot)
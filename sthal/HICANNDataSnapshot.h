@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+#include <boost/serialization/version.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "sthal/HICANNData.h"
+
+namespace sthal {
+
+/// Immutable snapshot of a HICANNData, as kept by the smart configurator to
+/// remember the written configuration.
+///
+/// The configuration blocks (floating gates, synapses, repeaters, ...) are held
+/// by shared pointers to const data: a snapshot taken with a previous snapshot of
+/// the same HICANN shares all blocks that did not change since, so only modified
+/// blocks are copied. Whether the synapse array changed is decided via its
+/// history and generation (cf. SynapseArray::history()) and a comparison of its
+/// drivers, without comparing weights and decoders. All other blocks are compared
+/// in full (operator==), i.e. taking a snapshot saves copies but is still linear in
+/// the size of these blocks, not in their number.
+/// The content hashes of the blocks are computed once per copied block.
+class HICANNDataSnapshot
+{
+public:
+	typedef std::pair<uint64_t, SynapseArray::generation_type> synapse_generation_t;
+
+	/// Snapshot of hicann, sharing unchanged blocks with previous (may be null)
+	explicit HICANNDataSnapshot(
+		HICANNData const& hicann, HICANNDataSnapshot const* previous = nullptr);
+
+	FloatingGates const& floating_gates() const;
+	AnalogOutput const& analog() const;
+	L1Repeaters const& repeater() const;
+	SynapseArray const& synapses() const;
+	Neurons const& neurons() const;
+	Layer1 const& layer1() const;
+	SynapseControllers const& synapse_controllers() const;
+	SynapseSwitches const& synapse_switches() const;
+	CrossbarSwitches const& crossbar_switches() const;
+
+	/// history and generation of the synapse array the snapshot was taken from,
+	/// {0, 0} for snapshots restored from an archive
+	synapse_generation_t synapse_generation() const;
+
+	/// number of blocks shared with the previous snapshot when this one was taken
+	size_t shared_blocks() const;
+
+	/// content hash of the snapshotted synapse array, cf. SynapseArray::content_hash()
+	uint64_t synapses_hash() const;
+	/// content hash of the whole snapshot, e.g. to detect identical HICANN configurations
+	uint64_t content_hash() const;
+
+	/// Copy of the snapshotted configuration
+	void copy_to(HICANNData& hicann) const;
+
+private:
+	HICANNDataSnapshot();
+
+#ifndef PYPLUSPLUS
+	template <typename T>
+	struct Block
+	{
+		typedef T value_type;
+		boost::shared_ptr<T const> data;
+		uint64_t hash;
+	};
+
+	Block<FloatingGates> m_floating_gates;
+	Block<AnalogOutput> m_analog;
+	Block<L1Repeaters> m_repeater;
+	Block<SynapseArray> m_synapses;
+	Block<Neurons> m_neurons;
+	Block<Layer1> m_layer1;
+	Block<SynapseControllers> m_synapse_controllers;
+	Block<SynapseSwitches> m_synapse_switches;
+	Block<CrossbarSwitches> m_crossbar_switches;
+#endif // !PYPLUSPLUS
+	std::array<FGStimulus, ::halco::hicann::v2::FGBlockOnHICANN::enum_type::size>
+		m_current_stimuli;
+
+	synapse_generation_t m_synapse_generation;
+	size_t m_shared_blocks;
+	uint64_t m_content_hash;
+
+	void update_content_hash();
+
+	friend class boost::serialization::access;
+	template<typename Archiver>
+	void serialize(Archiver & ar, unsigned int const version);
+};
+
+} // end namespace sthal
+
+BOOST_CLASS_VERSION(sthal::HICANNDataSnapshot, 0)
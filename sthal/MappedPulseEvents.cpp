@@ -0,0 +1,90 @@
+#include "sthal/MappedPulseEvents.h"
+
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+extern "C" {
+#include <sys/mman.h>
+}
+
+namespace sthal {
+
+static_assert(
+    std::is_trivially_copyable<MappedPulseEvents::PulseEvent>::value,
+    "pulse events are stored as raw bytes in the mapped file");
+
+MappedPulseEvents::MappedPulseEvents(std::string const& directory, size_t const size)
+	: m_directory(directory), m_size(size)
+{
+	if (m_size == 0) {
+		return;
+	}
+
+	boost::filesystem::path const filename =
+	    boost::filesystem::path(directory) /
+	    boost::filesystem::unique_path("sthal-pulses-%%%%-%%%%-%%%%-%%%%");
+	{
+		std::filebuf buf;
+		if (!buf.open(filename.c_str(), std::ios_base::out | std::ios_base::binary)) {
+			throw std::runtime_error(
+			    "MappedPulseEvents: could not create '" + filename.string() + "'");
+		}
+	}
+	boost::filesystem::resize_file(filename, m_size * sizeof(PulseEvent));
+
+	namespace bip = boost::interprocess;
+	bip::file_mapping const mapping(filename.c_str(), bip::read_write);
+	m_region.reset(new bip::mapped_region(mapping, bip::read_write));
+	m_region->advise(bip::mapped_region::advice_sequential);
+
+	// the mapping keeps the data accessible, the name is not needed anymore
+	boost::filesystem::remove(filename);
+}
+
+MappedPulseEvents::~MappedPulseEvents()
+{
+}
+
+auto MappedPulseEvents::data() -> PulseEvent*
+{
+	return m_region ? static_cast<PulseEvent*>(m_region->get_address()) : nullptr;
+}
+
+auto MappedPulseEvents::data() const -> PulseEvent const*
+{
+	return m_region ? static_cast<PulseEvent const*>(m_region->get_address()) : nullptr;
+}
+
+size_t MappedPulseEvents::size() const
+{
+	return m_size;
+}
+
+std::string const& MappedPulseEvents::directory() const
+{
+	return m_directory;
+}
+
+void MappedPulseEvents::release(size_t const begin, size_t const end)
+{
+	if (!m_region || begin >= end) {
+		return;
+	}
+	// only whole pages can be dropped, the mapping starts at a page boundary
+	size_t const page = boost::interprocess::mapped_region::get_page_size();
+	size_t const first = (begin * sizeof(PulseEvent) + page - 1) / page * page;
+	size_t const last = end * sizeof(PulseEvent) / page * page;
+	if (first >= last) {
+		return;
+	}
+	m_region->flush(first, last - first, false);
+	char* const address = static_cast<char*>(m_region->get_address()) + first;
+	::madvise(address, last - first, MADV_DONTNEED);
+}
+
+} // end namespace sthal
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "hal/FPGAContainer.h"
+
+namespace boost {
+namespace interprocess {
+class mapped_region;
+} // interprocess
+} // boost
+
+namespace sthal {
+
+/**
+ * @brief Fixed-size array of pulse events backed by a memory-mapped file.
+ * The file is created with a unique name in the given directory and unlinked
+ * right after mapping, so it never outlives the mapping (not even on crashes).
+ * Pages are written back to the file instead of swap, so traces held for a
+ * long time do not stay resident in anonymous memory. Filled parts can be
+ * released right away (cf. release()) to keep the resident memory low while
+ * filling the array.
+ */
+class MappedPulseEvents
+{
+public:
+	typedef ::HMF::FPGA::PulseEvent PulseEvent;
+
+	MappedPulseEvents(std::string const& directory, size_t size);
+	~MappedPulseEvents();
+
+	MappedPulseEvents(MappedPulseEvents const&) = delete;
+	MappedPulseEvents& operator=(MappedPulseEvents const&) = delete;
+
+	PulseEvent* data();
+	PulseEvent const* data() const;
+	size_t size() const;
+	/// directory the file was created in
+	std::string const& directory() const;
+
+	/// Writes the events [begin, end) back to the file and drops the pages holding only
+	/// those events from memory. They stay accessible and are read back on access.
+	void release(size_t begin, size_t end);
+
+private:
+	std::string m_directory;
+	size_t m_size;
+	std::unique_ptr<boost::interprocess::mapped_region> m_region;
+};
+
+} // end namespace sthal
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace boost {
+namespace archive {
+class binary_iarchive;
+class binary_oarchive;
+} // archive
+} // boost
+
+namespace sthal {
+
+/// Whether Archiver stores large fixed-size arrays as packed byte blocks, e.g.
+/// SynapseArray and FloatingGates. Only binary archives do, text and xml archives
+/// stay readable element by element.
+template <typename Archiver>
+struct is_packed_archive
+	: std::integral_constant<
+		  bool,
+		  std::is_same<Archiver, boost::archive::binary_oarchive>::value ||
+		      std::is_same<Archiver, boost::archive::binary_iarchive>::value>
+{};
+
+/// Number of bytes needed for n values of the given bit width
+inline size_t packed_size(size_t const n, size_t const bits)
+{
+	return (n * bits + 7) / 8;
+}
+
+/// Stores the lowest bits of value as index-th value of the given bit width,
+/// least significant bit first. data has to be zero-initialized.
+inline void pack_bits(
+	std::vector<uint8_t>& data, size_t const bits, size_t const index, uint32_t const value)
+{
+	size_t bit = index * bits;
+	for (size_t ii = 0; ii < bits; ++ii, ++bit) {
+		data[bit / 8] |= uint8_t(((value >> ii) & 1u) << (bit % 8));
+	}
+}
+
+/// Inverse of pack_bits()
+inline uint32_t unpack_bits(std::vector<uint8_t> const& data, size_t const bits, size_t const index)
+{
+	uint32_t value = 0;
+	size_t bit = index * bits;
+	for (size_t ii = 0; ii < bits; ++ii, ++bit) {
+		value |= uint32_t((data[bit / 8] >> (bit % 8)) & 1u) << ii;
+	}
+	return value;
+}
+
+} // end namespace sthal
@@ -1,7 +1,9 @@
 #include "sthal/ParallelHICANNv4Configurator.h"
 #include "sthal/Settings.h"
 
+#include <algorithm>
 #include <cstdlib>
+#include <deque>
 #include <sstream>
 #include <boost/ref.hpp>
 #include <log4cxx/logger.h>
@@ -10,6 +12,7 @@
 #include "pythonic/zip.h"
 
 #include "halco/common/iter_all.h"
+#include "halco/common/typed_array.h"
 #include "halco/hicann/v2/format_helper.h"
 #include "hal/HICANNContainer.h"
 #include "hal/Handle/FPGA.h"
@@ -109,13 +112,21 @@ const std::array< ::HMF::HICANN::neuron_parameter, 12> CURRENT_PARAMETERS{{
 	return minimum;
 }
 
-std::pair<row_list_t, row_list_t> get_current_rows(
-	const HICANNData& hicann, ::HMF::HICANN::FGRow::value_type lower_limit)
+} // namespace
+
+const ParallelHICANNv4Configurator::row_list_t ParallelHICANNv4Configurator::CURRENT_ROWS =
+	make_rows(1, 2);
+
+const ParallelHICANNv4Configurator::row_list_t ParallelHICANNv4Configurator::VOLTAGE_ROWS =
+	make_rows(0, 2);
+
+std::pair<row_list_t, row_list_t> ParallelHICANNv4Configurator::current_rows(
+	const FloatingGates& fg, ::HMF::HICANN::FGRow::value_type lower_limit)
 {
 	using namespace ::HMF::HICANN;
 	std::vector<bool> parameter_is_high(CURRENT_PARAMETERS.size(), false);
 	for (auto block : iter_all<FGBlockOnHICANN>()) {
-		const FGBlock& blk = hicann.floating_gates[block];
+		const FGBlock& blk = fg[block];
 		for (auto it : pythonic::enumerate(CURRENT_PARAMETERS)) {
 			FGRow row = blk.getFGRow(getNeuronRow(block, it.second));
 			parameter_is_high[it.first] =
@@ -133,13 +144,18 @@ std::pair<row_list_t, row_list_t> get_current_rows(
 	return std::make_pair(low, high);
 }
 
-} // namespace
-
-const ParallelHICANNv4Configurator::row_list_t ParallelHICANNv4Configurator::CURRENT_ROWS =
-	make_rows(1, 2);
-
-const ParallelHICANNv4Configurator::row_list_t ParallelHICANNv4Configurator::VOLTAGE_ROWS =
-	make_rows(0, 2);
+std::pair<row_list_t, row_list_t> ParallelHICANNv4Configurator::split_fg_rows(
+	const FloatingGates& fg, row_list_t const& rows, ::HMF::HICANN::FGRow::value_type lower_limit)
+{
+	row_list_t const current_high = current_rows(fg, lower_limit).second;
+	row_list_t normal, high;
+	for (auto const& row : rows) {
+		bool const is_high =
+			std::find(current_high.begin(), current_high.end(), row) != current_high.end();
+		(is_high ? high : normal).push_back(row);
+	}
+	return std::make_pair(normal, high);
+}
 
 void ParallelHICANNv4Configurator::setFastUpwardsLimit(size_t limit)
 {
@@ -148,6 +164,68 @@ void ParallelHICANNv4Configurator::setFastUpwardsLimit(size_t limit)
 	mFastUpwardsLimit = limit;
 }
 
+void ParallelHICANNv4Configurator::setSynapseWriteOrder(SynapseWriteOrder order)
+{
+	mSynapseWriteOrder = order;
+}
+
+ParallelHICANNv4Configurator::SynapseWriteOrder
+ParallelHICANNv4Configurator::getSynapseWriteOrder() const
+{
+	return mSynapseWriteOrder;
+}
+
+ParallelHICANNv4Configurator::synapse_driver_list_t
+ParallelHICANNv4Configurator::synapse_driver_order(SynapseWriteOrder order)
+{
+	synapse_driver_list_t drivers;
+	drivers.reserve(SynapseDriverOnHICANN::size);
+
+	switch (order) {
+		case SynapseWriteOrder::Sequential: {
+			for (auto syndrv : iter_all<SynapseDriverOnHICANN>()) {
+				drivers.push_back(syndrv);
+			}
+			break;
+		}
+		case SynapseWriteOrder::Alternating: {
+			// both synapse controllers serve the same number of drivers
+			typed_array<synapse_driver_list_t, SynapseArrayOnHICANN> per_array;
+			for (auto syndrv : iter_all<SynapseDriverOnHICANN>()) {
+				per_array[syndrv.toSynapseArrayOnHICANN()].push_back(syndrv);
+			}
+			size_t const per_controller = SynapseDriverOnHICANN::size / SynapseArrayOnHICANN::size;
+			for (size_t ii = 0; ii < per_controller; ++ii) {
+				for (auto const& array_drivers : per_array) {
+					drivers.push_back(array_drivers.at(ii));
+				}
+			}
+			break;
+		}
+		default:
+			throw std::invalid_argument("unknown synapse write order");
+	}
+	return drivers;
+}
+
+void ParallelHICANNv4Configurator::write_decoder_double_row(
+	hicann_handles_t const& handles,
+	std::vector< ::HMF::HICANN::SynapseController> const& synapse_controllers,
+	SynapseDriverOnHICANN const& syndrv,
+	std::vector< ::HMF::HICANN::DecoderDoubleRow> const& data)
+{
+	::HMF::HICANN::set_decoder_double_row(handles, synapse_controllers, syndrv, data);
+}
+
+void ParallelHICANNv4Configurator::write_weights_row(
+	hicann_handles_t const& handles,
+	std::vector< ::HMF::HICANN::SynapseController> const& synapse_controllers,
+	SynapseRowOnHICANN const& synrow,
+	std::vector< ::HMF::HICANN::WeightRow> const& data)
+{
+	::HMF::HICANN::set_weights_row(handles, synapse_controllers, synrow, data);
+}
+
 void ParallelHICANNv4Configurator::config(fpga_handle_t const& f,
                                           hicann_handles_t const& handles,
                                           hicann_datas_t const& hicanns, ConfigurationStage stage) {
@@ -181,46 +259,61 @@ void ParallelHICANNv4Configurator::config(fpga_handle_t const& f,
 			// interleaved and only via highspeed
 			config_synapse_array(highspeed_hicann_handles, highspeed_hicann_datas);
 
+			std::vector<bool> is_highspeed;
+			is_highspeed.reserve(handles.size());
 			for (auto handle : handles) {
-				if (std::find(
-				        highspeed_hicann_handles.begin(), highspeed_hicann_handles.end(), handle) ==
-				    highspeed_hicann_handles.end()) {
+				bool const highspeed =
+				    std::find(
+				        highspeed_hicann_handles.begin(), highspeed_hicann_handles.end(),
+				        handle) != highspeed_hicann_handles.end();
+				if (!highspeed) {
 					LOG4CXX_WARN(
 					    getLogger(), "Skipping synapse array configuration for non-highspeed "
 					                     << short_format(handle->coordinate()));
-				}
-			}
-
-			// TODO: make parallel/interleaved (no bottleneck here?)
-			auto it_data = hicanns.begin();
-			for (auto handle : handles) {
-				auto hicann = *it_data;
-
-				init_controllers(handle, hicann);
-
-				config_phase(handle, hicann);
-				config_gbitlink(handle, hicann);
-				config_fg_stimulus(handle, *it_data);
-				config_synapse_switch(handle, hicann);
-				config_stdp(handle, hicann);
-				config_crossbar_switches(handle, hicann);
-				config_merger_tree(handle, hicann);
-				config_dncmerger(handle, hicann);
-				config_background_generators(handle, hicann);
-				config_repeater(handle, hicann);
-
-				// configure synapse drivers
-				if (std::find(
-				        highspeed_hicann_handles.begin(), highspeed_hicann_handles.end(), handle) !=
-				    highspeed_hicann_handles.end()) {
-					config_synapse_drivers(handle, hicann);
-				} else {
 					LOG4CXX_WARN(
 					    getLogger(), "Skipping synapse driver configuration for non-highspeed "
 					                     << short_format(handle->coordinate()));
 				}
-				++it_data;
+				is_highspeed.push_back(highspeed);
 			}
+
+			// interleaved: each step is issued to all HICANNs before the next one, so
+			// the (non-blocking) writes of the HICANNs behind this FPGA are processed
+			// concurrently instead of filling one command buffer after the other.
+			// The caller syncs the command buffers of all HICANNs once at the end of
+			// the stage.
+			typedef void (HICANNConfigurator::*step_t)(
+			    hicann_handle_t const&, hicann_data_t const&);
+			auto const on_all_hicanns = [this, &handles, &hicanns, &is_highspeed](
+			                                step_t step, bool highspeed_only) {
+				for (size_t ii = 0; ii != handles.size(); ++ii) {
+					if (highspeed_only && !is_highspeed[ii]) {
+						continue;
+					}
+					(this->*step)(handles[ii], hicanns[ii]);
+				}
+			};
+
+			auto const t_steps = Timer::from_literal_string(__PRETTY_FUNCTION__);
+
+			on_all_hicanns(&HICANNConfigurator::init_controllers, false);
+			on_all_hicanns(&HICANNConfigurator::config_phase, false);
+			on_all_hicanns(&HICANNConfigurator::config_gbitlink, false);
+			on_all_hicanns(&HICANNConfigurator::config_fg_stimulus, false);
+			on_all_hicanns(&HICANNConfigurator::config_synapse_switch, false);
+			on_all_hicanns(&HICANNConfigurator::config_stdp, false);
+			on_all_hicanns(&HICANNConfigurator::config_crossbar_switches, false);
+			on_all_hicanns(&HICANNConfigurator::config_merger_tree, false);
+			on_all_hicanns(&HICANNConfigurator::config_dncmerger, false);
+			on_all_hicanns(&HICANNConfigurator::config_background_generators, false);
+			on_all_hicanns(&HICANNConfigurator::config_repeater, false);
+			// configure synapse drivers
+			on_all_hicanns(&HICANNConfigurator::config_synapse_drivers, true);
+
+			LOG4CXX_DEBUG(getTimeLogger(), short_format(f->coordinate())
+			                                   << ": interleaved configuration of "
+			                                   << handles.size() << " HICANN(s) took "
+			                                   << t_steps.get_ms() << "ms");
 			break;
 		}
 		case ConfigurationStage::LOCKING_REPEATER_BLOCKS: {
@@ -318,7 +411,8 @@ void ParallelHICANNv4Configurator::config_floating_gates(
 	row_lists_t current_lows, current_highs;
 	for (auto hicann : hicanns) {
 		row_list_t current_low, current_high;
-		std::tie(current_low, current_high) = get_current_rows(*hicann, mFastUpwardsLimit);
+		std::tie(current_low, current_high) =
+			current_rows(hicann->floating_gates, mFastUpwardsLimit);
 		current_lows.push_back(current_low);
 		current_highs.push_back(current_high);
 	}
@@ -357,29 +451,30 @@ void ParallelHICANNv4Configurator::config_synapse_array(
 	LOG4CXX_DEBUG(getLogger(), "configure synapses in parallel for " << n_hicanns
 	                                                                 << " HICANN(s)");
 
-	// TODO: interleave calls to top / bottom synapse controllers
-	for (auto syndrv : iter_all<SynapseDriverOnHICANN>()) {
+	for (auto syndrv : synapse_driver_order(mSynapseWriteOrder)) {
 		std::vector<HMF::HICANN::DecoderDoubleRow> decoder_data;
 		std::vector<HMF::HICANN::SynapseController> synapse_controllers;
 		decoder_data.reserve(n_hicanns);
 		synapse_controllers.reserve(n_hicanns);
 		for (auto data : hicanns) {
-			decoder_data.push_back(data->synapses.getDecoderDoubleRow(syndrv));
+			SynapseArray const& synapses = data->synapses;
+			decoder_data.push_back(synapses.getDecoderDoubleRow(syndrv));
 			synapse_controllers.push_back(static_cast<HMF::HICANN::SynapseController>(
 				data->synapse_controllers[syndrv.toSynapseArrayOnHICANN()]));
 		}
 
-		set_decoder_double_row(handles, synapse_controllers, syndrv, decoder_data);
+		write_decoder_double_row(handles, synapse_controllers, syndrv, decoder_data);
 		for (auto side : iter_all<SideVertical>()) {
 			SynapseRowOnHICANN const synrow(syndrv, RowOnSynapseDriver(side));
 
 			std::vector<HMF::HICANN::WeightRow> weight_data;
 			weight_data.reserve(n_hicanns);
 			for (auto data : hicanns) {
-				weight_data.push_back(data->synapses[synrow].weights);
+				SynapseArray const& synapses = data->synapses;
+				weight_data.push_back(synapses[synrow].weights);
 			}
 
-			set_weights_row(handles, synapse_controllers, synrow, weight_data);
+			write_weights_row(handles, synapse_controllers, synrow, weight_data);
 		}
 	}
 
@@ -388,6 +483,39 @@ void ParallelHICANNv4Configurator::config_synapse_array(
 	                                   << "ms");
 }
 
+void ParallelHICANNv4Configurator::run_fg_write_queues(
+	std::vector<size_t> const& n_writes,
+	std::function<bool(size_t, size_t)> const& write,
+	std::function<void(size_t)> const& wait)
+{
+	const size_t n_hicanns = n_writes.size();
+	std::vector<size_t> next_step(n_hicanns, 0);
+	// HICANNs with a write in flight, in the order the writes were issued
+	std::deque<size_t> in_flight;
+
+	auto issue_next = [&](size_t const i) {
+		while (next_step[i] < n_writes[i]) {
+			if (write(i, next_step[i]++)) {
+				in_flight.push_back(i);
+				return;
+			}
+		}
+	};
+
+	for (size_t i = 0; i != n_hicanns; ++i) {
+		issue_next(i);
+	}
+
+	// wait_fg blocks and cannot tell which controller becomes idle first, so the
+	// writes are completed in issue order
+	while (!in_flight.empty()) {
+		size_t const i = in_flight.front();
+		in_flight.pop_front();
+		wait(i);
+		issue_next(i);
+	}
+}
+
 void ParallelHICANNv4Configurator::zero_fg(
 	hicann_handles_t const& handles, hicann_datas_t const& hicanns)
 {
@@ -408,33 +536,28 @@ void ParallelHICANNv4Configurator::zero_fg(
 		for (size_t i = 0; i != n_hicanns; ++i)
 			::HMF::HICANN::set_fg_config(*handles[i], block, fgconfigs[i]);
 
-	auto write_row_on_all_blocks = [&handles, &n_hicanns,
-	                                &fgconfigs](::HMF::HICANN::FGRowOnFGBlock4 const& row) {
-		::HMF::HICANN::FGRow4 const row_data; // zeroed data
-		// write FGRow4 to all blocks
-		for (size_t i = 0; i != n_hicanns; ++i) {
-			if (!handles[i]->highspeed() &&
-			    !any_l1_row(row)) {
+	row_list_t rows(CURRENT_ROWS);
+	rows.insert(rows.end(), VOLTAGE_ROWS.begin(), VOLTAGE_ROWS.end());
+
+	::HMF::HICANN::FGRow4 const row_data; // zeroed data
+	run_fg_write_queues(
+		std::vector<size_t>(n_hicanns, rows.size()),
+		[&](size_t const i, size_t const step) {
+			auto const& row = rows[step];
+			if (!handles[i]->highspeed() && !any_l1_row(row)) {
 				LOG4CXX_INFO(
 				    getLogger(), "Skipping FG rows " << row[0] << " " << row[1] << " " << row[2]
 				                                     << " " << row[3]
 				                                     << " not essential for L1 on non-highspeed "
 				                                     << short_format(handles[i]->coordinate()));
-				continue;
+				return false;
 			}
+			// write FGRow4 to all blocks
 			::HMF::HICANN::set_fg_row_values(
 				*handles[i], row, row_data, fgconfigs[i].writeDown, /* blocking */ false);
-		}
-		// wait for fg controller to finish
-		for (size_t i = 0; i != n_hicanns; ++i)
-			::HMF::HICANN::wait_fg(*handles[i]);
-	};
-
-	for (auto row : CURRENT_ROWS)
-		write_row_on_all_blocks(row);
-
-	for (auto row : VOLTAGE_ROWS)
-		write_row_on_all_blocks(row);
+			return true;
+		},
+		[&handles](size_t const i) { ::HMF::HICANN::wait_fg(*handles[i]); });
 
 	LOG4CXX_DEBUG(getTimeLogger(), "zero floating gates took " << t.get_ms() << "ms");
 }
@@ -443,7 +566,8 @@ void ParallelHICANNv4Configurator::program_normal(
 	hicann_handles_t const& handles,
 	hicann_datas_t const& hicanns,
 	row_lists_t const& rows,
-	bool zero_neuron_parameters)
+	bool zero_neuron_parameters,
+	std::vector<FGConfig> const& passes)
 {
 	auto t = Timer::from_literal_string(__PRETTY_FUNCTION__);
 	LOG4CXX_DEBUG(getLogger(), "update normal rows");
@@ -455,98 +579,102 @@ void ParallelHICANNv4Configurator::program_normal(
 
 	LOG4CXX_DEBUG(getLogger(), "Have " << n_hicanns << " HICANNs");
 
-	// maximum number of passes for each hicann
-	std::vector<size_t> maxProgrammingPasses(hicanns.size());
-	std::transform(
-		hicanns.begin(), hicanns.end(), maxProgrammingPasses.begin(),
-		[](boost::shared_ptr<HICANNData const> h) {
-			return h->floating_gates.getNoProgrammingPasses();
-		});
-
-	// maximum FG programming time over all HICANNs
-	size_t const totalMaxProgrammingPasses =
-		*(std::max_element(maxProgrammingPasses.begin(), maxProgrammingPasses.end()));
+	auto const no_passes = [&](size_t const i) -> size_t {
+		return passes.empty() ? size_t(hicanns[i]->floating_gates.getNoProgrammingPasses())
+		                      : passes.size();
+	};
 
-	std::vector<size_t> maxRows(rows.size());
-	std::transform(
-		rows.begin(), rows.end(), maxRows.begin(), [](row_list_t r) { return r.size(); });
-	size_t const maxRowsOnAnyHICANN = *(std::max_element(maxRows.begin(), maxRows.end()));
+	// each HICANN writes all of its rows in each of its programming passes,
+	// the FG config of a pass is set before its first row
+	std::vector<size_t> n_writes(n_hicanns);
+	for (size_t i = 0; i != n_hicanns; ++i) {
+		n_writes[i] = no_passes(i) * rows[i].size();
+	}
 
-	for (size_t pass = 0; pass != totalMaxProgrammingPasses; ++pass) {
-		LOG4CXX_DEBUG(
-			getLogger(),
-			"FG: writing FG blocks (pass " << pass + 1
-			<< " out of " << totalMaxProgrammingPasses << "): ");
+	run_fg_write_queues(
+		n_writes,
+		[&](size_t const i, size_t const step) {
+			size_t const pass = step / rows[i].size();
+			size_t const r = step % rows[i].size();
+			const FloatingGates& fg = hicanns[i]->floating_gates;
+			FGConfig const cfg = passes.empty() ? fg.getFGConfig(Enum(pass)) : passes[pass];
 
-		// configure all hicanns
-		for (size_t i = 0; i != n_hicanns; ++i) {
-			if (pass < maxProgrammingPasses[i]) {
-				LOG4CXX_DEBUG(getLogger(), "FG: configuring HICANN " << i);
-				const FloatingGates& fg = hicanns[i]->floating_gates;
-				FGConfig cfg = fg.getFGConfig(Enum(pass));
+			if (r == 0) {
+				LOG4CXX_DEBUG(
+					getLogger(), "FG: configuring HICANN " << i << " for pass " << pass + 1
+					<< " out of " << no_passes(i));
 				for (auto block : iter_all<FGBlockOnHICANN>()) {
 					::HMF::HICANN::set_fg_config(*handles[i], block, cfg);
 				}
 			}
-		}
-
-		// all rows on all hicanns
-		for (size_t r = 0; r < maxRowsOnAnyHICANN; r++) {
-			for (size_t i = 0; i != n_hicanns; ++i) {
-				LOG4CXX_DEBUG(
-					getLogger(),
-					"Have " << r << "/" << rows[i].size() << " on HICANN " << i
-					<< " (" << n_hicanns << " HICANNs in total)");
-				if ((r < rows[i].size()) && (pass < maxProgrammingPasses[i])) {
-					auto row = rows[i][r];
-					if (!handles[i]->highspeed() &&
-					    !any_l1_row(row)) {
-						LOG4CXX_INFO(
-						    getLogger(), "Skipping FG rows "
-						                     << row[0] << " " << row[1] << " " << row[2] << " "
-						                     << row[3] << " not essential for L1 on non-highspeed "
-						                     << short_format(handles[i]->coordinate()));
-						continue;
-					}
-					// row in list...
-					LOG4CXX_DEBUG(getLogger(), "FG: writing HICANN " << i);
-					const FloatingGates& fg = hicanns[i]->floating_gates;
-					FGConfig cfg = fg.getFGConfig(Enum(pass));
-					::HMF::HICANN::FGRow4 row_data{
-						{hicanns[i]->floating_gates[FGBlockOnHICANN(Enum(0))].getFGRow(row[0]),
-						 hicanns[i]->floating_gates[FGBlockOnHICANN(Enum(1))].getFGRow(row[1]),
-						 hicanns[i]->floating_gates[FGBlockOnHICANN(Enum(2))].getFGRow(row[2]),
-						 hicanns[i]->floating_gates[FGBlockOnHICANN(Enum(3))].getFGRow(row[3])}};
-
-					if (zero_neuron_parameters) {
-						for (::HMF::HICANN::FGRow& fgrow : row_data) {
-							for (auto nrn_c : iter_all<NeuronOnFGBlock>()) {
-								fgrow.setNeuron(nrn_c, 0);
-							}
-						}
-					}
 
-					LOG4CXX_TRACE(getLogger(), "updating rows " << row);
-					::HMF::HICANN::set_fg_row_values(
-						*handles[i], row, row_data, cfg.writeDown, /* blocking */ false);
-				}
+			auto const& row = rows[i][r];
+			if (!handles[i]->highspeed() && !any_l1_row(row)) {
+				LOG4CXX_INFO(
+				    getLogger(), "Skipping FG rows "
+				                     << row[0] << " " << row[1] << " " << row[2] << " "
+				                     << row[3] << " not essential for L1 on non-highspeed "
+				                     << short_format(handles[i]->coordinate()));
+				return false;
 			}
 
-			// wait for for on all hicanns
-			for (size_t i = 0; i != n_hicanns; ++i) {
-				if (r < rows[i].size()) {
-					if (pass < maxProgrammingPasses[i]) {
-						LOG4CXX_DEBUG(getLogger(), "FG: waiting for HICANN " << i);
-						::HMF::HICANN::wait_fg(*handles[i]);
+			LOG4CXX_DEBUG(getLogger(), "FG: writing row " << r << "/" << rows[i].size()
+			                                              << " on HICANN " << i);
+			::HMF::HICANN::FGRow4 row_data{
+				{fg[FGBlockOnHICANN(Enum(0))].getFGRow(row[0]),
+				 fg[FGBlockOnHICANN(Enum(1))].getFGRow(row[1]),
+				 fg[FGBlockOnHICANN(Enum(2))].getFGRow(row[2]),
+				 fg[FGBlockOnHICANN(Enum(3))].getFGRow(row[3])}};
+
+			if (zero_neuron_parameters) {
+				for (::HMF::HICANN::FGRow& fgrow : row_data) {
+					for (auto nrn_c : iter_all<NeuronOnFGBlock>()) {
+						fgrow.setNeuron(nrn_c, 0);
 					}
 				}
 			}
-		} // loop over Rows
-	}     // loop over passes
+
+			LOG4CXX_TRACE(getLogger(), "updating rows " << row);
+			::HMF::HICANN::set_fg_row_values(
+				*handles[i], row, row_data, cfg.writeDown, /* blocking */ false);
+			return true;
+		},
+		[&handles](size_t const i) {
+			LOG4CXX_DEBUG(getLogger(), "FG: waiting for HICANN " << i);
+			::HMF::HICANN::wait_fg(*handles[i]);
+		});
 
 	LOG4CXX_DEBUG(getTimeLogger(), "update normal rows took " << t.get_ms() << "ms");
 }
 
+void ParallelHICANNv4Configurator::update_fg_rows(
+	hicann_handles_t const& handles,
+	hicann_datas_t const& hicanns,
+	row_lists_t const& rows,
+	std::vector<FGConfig> const& passes)
+{
+	auto t = Timer::from_literal_string(__PRETTY_FUNCTION__);
+
+	if ((handles.size() != hicanns.size()) || (hicanns.size() != rows.size()))
+		throw std::invalid_argument(
+			"the number of handles, data containers and rows parameter has to be equal");
+	const size_t n_hicanns = hicanns.size();
+
+	row_lists_t normal_rows(n_hicanns), high_rows(n_hicanns);
+	for (size_t i = 0; i != n_hicanns; ++i) {
+		std::tie(normal_rows[i], high_rows[i]) =
+			split_fg_rows(hicanns[i]->floating_gates, rows[i], mFastUpwardsLimit);
+		LOG4CXX_DEBUG(
+			getLogger(), "FG: updating " << rows[i].size() << " rows on "
+			                             << short_format(handles[i]->coordinate()));
+	}
+
+	program_normal(handles, hicanns, normal_rows, /*zero_neuron_parameters=*/false, passes);
+	program_high(handles, hicanns, high_rows);
+
+	LOG4CXX_DEBUG(getTimeLogger(), "updating FG rows took " << t.get_ms() << "ms");
+}
+
 void ParallelHICANNv4Configurator::program_high(
 	hicann_handles_t const& handles, hicann_datas_t const& hicanns, row_lists_t const& rows)
 {
@@ -567,46 +695,37 @@ void ParallelHICANNv4Configurator::program_high(
 		}
 	}
 
-	std::vector<size_t> maxRows(rows.size());
+	std::vector<size_t> n_writes(n_hicanns);
 	std::transform(
-		rows.begin(), rows.end(), maxRows.begin(), [](row_list_t r) { return r.size(); });
-	size_t const maxRowsOnAnyHICANN = *(std::max_element(maxRows.begin(), maxRows.end()));
-
-	for (size_t r = 0; r < maxRowsOnAnyHICANN; r++) {
-		for (size_t i = 0; i != n_hicanns; ++i) {
-			LOG4CXX_DEBUG(
-				getLogger(), "Have " << r << "/" << rows[i].size() << " on HICANN " << i
-				<< " (" << n_hicanns << " HICANNs in total)");
-			if (r < rows[i].size()) {
-				auto row = rows[i][r];
-				if (!handles[i]->highspeed() &&
-				    !any_l1_row(row)) {
-					LOG4CXX_INFO(
-					    getLogger(), "Skipping FG rows "
-					                     << row[0] << " " << row[1] << " " << row[2] << " "
-					                     << row[3] << " not essential for L1 on non-highspeed "
-					                     << short_format(handles[i]->coordinate()));
-					continue;
-				}
-				::HMF::HICANN::FGRow4 row_data{
-					{hicanns[i]->floating_gates[FGBlockOnHICANN(Enum(0))].getFGRow(row[0]),
-					 hicanns[i]->floating_gates[FGBlockOnHICANN(Enum(1))].getFGRow(row[1]),
-					 hicanns[i]->floating_gates[FGBlockOnHICANN(Enum(2))].getFGRow(row[2]),
-					 hicanns[i]->floating_gates[FGBlockOnHICANN(Enum(3))].getFGRow(row[3])}};
-				LOG4CXX_TRACE(getLogger(), "updating rows " << row);
-				::HMF::HICANN::set_fg_row_values(
-					*handles[i], row, row_data, fgconfigs[i].writeDown, /* blocking */ false);
-			}
-		}
+		rows.begin(), rows.end(), n_writes.begin(), [](row_list_t const& r) { return r.size(); });
 
-		// wait for for on all hicanns
-		for (size_t i = 0; i != n_hicanns; ++i) {
-			if (r < rows[i].size()) {
-				LOG4CXX_DEBUG(getLogger(), "FG: waiting for HICANN " << i);
-				::HMF::HICANN::wait_fg(*handles[i]);
+	run_fg_write_queues(
+		n_writes,
+		[&](size_t const i, size_t const r) {
+			auto const& row = rows[i][r];
+			if (!handles[i]->highspeed() && !any_l1_row(row)) {
+				LOG4CXX_INFO(
+				    getLogger(), "Skipping FG rows "
+				                     << row[0] << " " << row[1] << " " << row[2] << " "
+				                     << row[3] << " not essential for L1 on non-highspeed "
+				                     << short_format(handles[i]->coordinate()));
+				return false;
 			}
-		}
-	}
+			const FloatingGates& fg = hicanns[i]->floating_gates;
+			::HMF::HICANN::FGRow4 row_data{
+				{fg[FGBlockOnHICANN(Enum(0))].getFGRow(row[0]),
+				 fg[FGBlockOnHICANN(Enum(1))].getFGRow(row[1]),
+				 fg[FGBlockOnHICANN(Enum(2))].getFGRow(row[2]),
+				 fg[FGBlockOnHICANN(Enum(3))].getFGRow(row[3])}};
+			LOG4CXX_TRACE(getLogger(), "updating rows " << row);
+			::HMF::HICANN::set_fg_row_values(
+				*handles[i], row, row_data, fgconfigs[i].writeDown, /* blocking */ false);
+			return true;
+		},
+		[&handles](size_t const i) {
+			LOG4CXX_DEBUG(getLogger(), "FG: waiting for HICANN " << i);
+			::HMF::HICANN::wait_fg(*handles[i]);
+		});
 
 	LOG4CXX_DEBUG(getTimeLogger(), "program up fast took " << t.get_ms() << "ms");
 }
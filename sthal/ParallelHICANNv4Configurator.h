@@ -1,5 +1,8 @@
 #pragma once
 
+#include <functional>
+#include <utility>
+
 #include "pywrap/compat/macros.hpp"
 
 #include "hal/HICANNContainer.h"
@@ -33,11 +36,55 @@ public:
 	typedef std::vector<row_list_t> row_lists_t;
 	PYPP_INSTANTIATE(std::vector<hicann_handle_t>)
 	PYPP_INSTANTIATE(std::vector<hicann_data_t>)
+	typedef std::vector< ::halco::hicann::v2::SynapseDriverOnHICANN> synapse_driver_list_t;
+
+	/// Order in which config_synapse_array writes the synapse drivers
+	///  - Sequential: from top to bottom, i.e. all rows of the top synapse
+	///        controller before the rows of the bottom one (default, the order
+	///        used by all earlier versions)
+	///  - Alternating: alternate between the top and bottom synapse controller,
+	///        so that both are kept busy
+	PYPP_CLASS_ENUM(SynapseWriteOrder){Sequential, Alternating};
 
 	/// If the smallest value of an FGRow is larger than limit, programm_high
 	/// is used to programm this line
 	void setFastUpwardsLimit(size_t limit);
 
+	void setSynapseWriteOrder(SynapseWriteOrder order);
+	SynapseWriteOrder getSynapseWriteOrder() const;
+
+	/// Synapse drivers in the order they are written for the given write order
+	static synapse_driver_list_t synapse_driver_order(SynapseWriteOrder order);
+
+#ifndef PYPLUSPLUS
+	/// Runs n_writes[i] floating gate writes on each HICANN i without lock-step rows
+	/// across HICANNs: write(i, step) issues the step non-blocking and returns whether
+	/// anything was written, wait(i) blocks until the FG controllers of HICANN i are
+	/// idle. HICANNs are waited for one after the other in the order their writes were
+	/// issued and the next step on a HICANN is issued right after the wait for it
+	/// returned. As wait blocks, a HICANN whose write finished early still waits for the
+	/// HICANNs queued before it; only HICANNs without further writes drop out.
+	static void run_fg_write_queues(
+		std::vector<size_t> const& n_writes,
+		std::function<bool(size_t, size_t)> const& write,
+		std::function<void(size_t)> const& wait);
+
+	/// Rows of the current parameters as written by config_floating_gates, split into
+	/// the ones programmed by program_normal (first) and the ones programmed fast
+	/// upwards by program_high (second), i.e. parameters with a row in any block whose
+	/// smallest value is not below lower_limit.
+	/// @note Rows of a parameter may differ between the blocks.
+	static std::pair<row_list_t, row_list_t> current_rows(
+		FloatingGates const& fg, ::HMF::HICANN::FGRow::value_type lower_limit);
+
+	/// Splits rows into the ones programmed by program_normal (first) and by
+	/// program_high (second) in config_floating_gates, cf. current_rows()
+	static std::pair<row_list_t, row_list_t> split_fg_rows(
+		FloatingGates const& fg,
+		row_list_t const& rows,
+		::HMF::HICANN::FGRow::value_type lower_limit);
+#endif // !PYPLUSPLUS
+
 	virtual void config(fpga_handle_t const& f, hicann_handles_t const& handles,
 	                    hicann_datas_t const& hicanns, ConfigurationStage stage);
 
@@ -49,6 +96,19 @@ public:
 	virtual void config_synapse_array(
 		hicann_handles_t const& handles, hicann_datas_t const& hicanns);
 
+	/// Writes the decoder double row of the given synapse driver on all HICANNs
+	virtual void write_decoder_double_row(
+		hicann_handles_t const& handles,
+		std::vector< ::HMF::HICANN::SynapseController> const& synapse_controllers,
+		::halco::hicann::v2::SynapseDriverOnHICANN const& syndrv,
+		std::vector< ::HMF::HICANN::DecoderDoubleRow> const& data);
+	/// Writes the weights of the given synapse row on all HICANNs
+	virtual void write_weights_row(
+		hicann_handles_t const& handles,
+		std::vector< ::HMF::HICANN::SynapseController> const& synapse_controllers,
+		::halco::hicann::v2::SynapseRowOnHICANN const& synrow,
+		std::vector< ::HMF::HICANN::WeightRow> const& data);
+
 	void ensure_correct_fg_biases(hicann_datas_t const& hicanns);
 
 	/// Writes all floating gate fast to zero
@@ -65,15 +125,30 @@ public:
 	/**
 	 * @param zero_neuron_parameters Whether to write zeros instead of the actual
 	 *        per-neuron parameters in all rows.
+	 * @param passes Programming passes to use instead of the ones of the floating
+	 *        gates of each HICANN, if not empty.
 	 */
 	void program_normal(
 		hicann_handles_t const& handles,
 		hicann_datas_t const& hicanns,
 		row_lists_t const& rows,
-		bool zero_neuron_parameters = false);
+		bool zero_neuron_parameters = false,
+		std::vector<FGConfig> const& passes = std::vector<FGConfig>());
+
+	/// Updates only the given rows to their current values, without zeroing the
+	/// floating gates first. Current rows that would be programmed fast upwards in
+	/// config_floating_gates are programmed by program_high, all others by
+	/// program_normal with the given passes (cf. program_normal, split_fg_rows).
+	/// Rows have to be taken from VOLTAGE_ROWS and current_rows().
+	void update_fg_rows(
+		hicann_handles_t const& handles,
+		hicann_datas_t const& hicanns,
+		row_lists_t const& rows,
+		std::vector<FGConfig> const& passes = std::vector<FGConfig>());
 
 #ifndef PYPLUSPLUS
 	::HMF::HICANN::FGRow::value_type mFastUpwardsLimit = 800;
+	SynapseWriteOrder mSynapseWriteOrder = SynapseWriteOrder::Sequential;
 #endif // !PYPLUSPLUS
 
 	static const row_list_t CURRENT_ROWS;
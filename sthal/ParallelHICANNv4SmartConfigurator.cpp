@@ -1,5 +1,6 @@
 #include "sthal/ParallelHICANNv4SmartConfigurator.h"
 
+#include <algorithm>
 #include <mutex>
 #include <boost/serialization/nvp.hpp>
 
@@ -16,6 +17,40 @@ using namespace ::halco::common;
 
 namespace sthal {
 
+namespace {
+
+/// Decoder double rows and weight rows of a synapse array that may differ from the
+/// previously written configuration: the ones modified since it was written if the
+/// array has the same history as the written one, otherwise all.
+struct SynapseCandidates
+{
+	typedef HICANNDataSnapshot::synapse_generation_t synapse_generation_t;
+
+	SynapseCandidates(SynapseArray const& synapses, synapse_generation_t const& written) :
+	    tracked(synapses.history() == written.first),
+	    any(!tracked || synapses.generation() > written.second),
+	    decoders(SynapseDriverOnHICANN::enum_type::size, !tracked),
+	    weights(SynapseRowOnHICANN::enum_type::size, !tracked)
+	{
+		if (!tracked) {
+			return;
+		}
+		for (auto const& driver : synapses.changed_decoders(written.second)) {
+			decoders[driver.toEnum().value()] = true;
+		}
+		for (auto const& row : synapses.changed_weights(written.second)) {
+			weights[row.toEnum().value()] = true;
+		}
+	}
+
+	bool tracked;
+	bool any;
+	std::vector<bool> decoders;
+	std::vector<bool> weights;
+};
+
+} // anonymous namespace
+
 ParallelHICANNv4SmartConfigurator::ParallelHICANNv4SmartConfigurator() :
     fg_config_mode(ParallelHICANNv4SmartConfigurator::ConfigMode::Smart),
     synapse_config_mode(ParallelHICANNv4SmartConfigurator::ConfigMode::Smart),
@@ -24,6 +59,7 @@ ParallelHICANNv4SmartConfigurator::ParallelHICANNv4SmartConfigurator() :
     repeater_config_mode(ParallelHICANNv4SmartConfigurator::ConfigMode::Smart),
     repeater_locking_config_mode(ParallelHICANNv4SmartConfigurator::ConfigMode::Smart),
     syn_drv_locking_config_mode(ParallelHICANNv4SmartConfigurator::ConfigMode::Smart),
+    fg_incremental(false),
     m_global_l1_bus_changes(true),
     m_started_systime(false)
 {
@@ -41,6 +77,55 @@ boost::shared_ptr<ParallelHICANNv4SmartConfigurator> ParallelHICANNv4SmartConfig
 	    new ParallelHICANNv4SmartConfigurator);
 }
 
+ParallelHICANNv4SmartConfigurator::row_list_t ParallelHICANNv4SmartConfigurator::changed_fg_rows(
+    FloatingGates const& written,
+    FloatingGates const& fg,
+    ::HMF::HICANN::FGRow::value_type fast_upwards_limit)
+{
+	// same rows as written by config_floating_gates, so that update_fg_rows programs
+	// each of them like a full write
+	row_list_t candidates(VOLTAGE_ROWS);
+	auto const current = current_rows(fg, fast_upwards_limit);
+	candidates.insert(candidates.end(), current.first.begin(), current.first.end());
+	candidates.insert(candidates.end(), current.second.begin(), current.second.end());
+	// the row of int_op_bias is written separately
+	size_t const intop = ::HMF::HICANN::shared_parameter::int_op_bias;
+	::HMF::HICANN::FGRowOnFGBlock4 const row_int_op_bias{
+		{FGRowOnFGBlock(intop), FGRowOnFGBlock(intop), FGRowOnFGBlock(intop),
+		 FGRowOnFGBlock(intop)}};
+	if (std::find(candidates.begin(), candidates.end(), row_int_op_bias) == candidates.end()) {
+		candidates.push_back(row_int_op_bias);
+	}
+
+	row_list_t rows;
+	for (auto const& row : candidates) {
+		bool changed = false;
+		for (auto block : iter_all<FGBlockOnHICANN>()) {
+			auto const block_row = row[block.toEnum().value()];
+			changed |= (written[block].getFGRow(block_row) != fg[block].getFGRow(block_row));
+		}
+		if (changed) {
+			rows.push_back(row);
+		}
+	}
+	return rows;
+}
+
+bool ParallelHICANNv4SmartConfigurator::same_programming_passes(
+    FloatingGates const& written, FloatingGates const& fg)
+{
+	size_t const passes = fg.getNoProgrammingPasses();
+	if (size_t(written.getNoProgrammingPasses()) != passes) {
+		return false;
+	}
+	for (size_t pass = 0; pass != passes; ++pass) {
+		if (written.getFGConfig(Enum(pass)) != fg.getFGConfig(Enum(pass))) {
+			return false;
+		}
+	}
+	return true;
+}
+
 void ParallelHICANNv4SmartConfigurator::config(
     fpga_handle_t const& fpga_handle,
     hicann_handles_t const& hicann_handle,
@@ -103,15 +188,27 @@ void ParallelHICANNv4SmartConfigurator::config_floating_gates(
 	auto t = Timer::from_literal_string(__PRETTY_FUNCTION__);
 	hicann_handles_t changed_handles;
 	hicann_datas_t changed_hicanns;
+	hicann_handles_t updated_handles;
+	hicann_datas_t updated_hicanns;
+	row_lists_t updated_rows;
 
 	// collect changed hicann handles/datas, skip config for others
 	for (size_t ii = 0; ii != hicanns.size(); ++ii) {
 		const hicann_coord coord = handles[ii]->coordinate();
-		const hicann_data_t old_hicann = mWrittenHICANNData.at(coord);
+		auto const old_hicann = mWrittenHICANNData.at(coord);
+		FloatingGates const& fg = hicanns[ii]->floating_gates;
 		if (!(fg_config_mode == ConfigMode::Skip) &&
-		    (old_hicann == nullptr || old_hicann->floating_gates != hicanns[ii]->floating_gates)) {
-			changed_handles.push_back(handles[ii]);
-			changed_hicanns.push_back(hicanns[ii]);
+		    (old_hicann == nullptr || old_hicann->floating_gates() != fg)) {
+			if (fg_incremental && old_hicann != nullptr &&
+			    same_programming_passes(old_hicann->floating_gates(), fg)) {
+				updated_handles.push_back(handles[ii]);
+				updated_hicanns.push_back(hicanns[ii]);
+				updated_rows.push_back(
+				    changed_fg_rows(old_hicann->floating_gates(), fg, mFastUpwardsLimit));
+			} else {
+				changed_handles.push_back(handles[ii]);
+				changed_hicanns.push_back(hicanns[ii]);
+			}
 		} else {
 			const size_t passes = hicanns[ii]->floating_gates.getNoProgrammingPasses();
 			if (passes > 0) {
@@ -129,13 +226,19 @@ void ParallelHICANNv4SmartConfigurator::config_floating_gates(
 
 	LOG4CXX_DEBUG(
 	    getLogger(), "Smartly configuring FG, skipping " +
-	                     std::to_string(handles.size() - changed_handles.size()) +
-	                     " configurations");
+	                     std::to_string(
+	                         handles.size() - changed_handles.size() - updated_handles.size()) +
+	                     " configurations, updating " + std::to_string(updated_handles.size()) +
+	                     " row-wise");
 
 	if (changed_handles.size() != 0) {
 		ParallelHICANNv4Configurator::config_floating_gates(changed_handles, changed_hicanns);
 	}
 
+	if (updated_handles.size() != 0) {
+		update_fg_rows(updated_handles, updated_hicanns, updated_rows, fg_incremental_passes);
+	}
+
 	LOG4CXX_INFO(getTimeLogger(), "Writing FG blocks took " << t.get_ms() << "ms");
 }
 
@@ -161,13 +264,22 @@ void ParallelHICANNv4SmartConfigurator::config_synapse_array(
 
 	hicann_handles_t all_changed_handles;
 	hicann_datas_t all_changed_hicanns;
+	std::vector<SynapseCandidates> all_changed_candidates;
 
 	for (size_t ii = 0; ii != n_hicanns; ++ii) {
 		const hicann_coord coord = handles[ii]->coordinate();
-		const hicann_data_t old_hicann = mWrittenHICANNData.at(coord);
-		if (old_hicann == nullptr || old_hicann->synapses != hicanns[ii]->synapses) {
+		auto const old_hicann = mWrittenHICANNData.at(coord);
+		SynapseArray const& synapses = hicanns[ii]->synapses;
+
+		SynapseCandidates candidates(
+		    synapses, old_hicann ? old_hicann->synapse_generation()
+		                         : HICANNDataSnapshot::synapse_generation_t(0, 0));
+		if (old_hicann == nullptr ||
+		    (candidates.any &&
+		     (candidates.tracked || old_hicann->synapses_hash() != synapses.content_hash()))) {
 			all_changed_handles.push_back(handles[ii]);
 			all_changed_hicanns.push_back(hicanns[ii]);
+			all_changed_candidates.push_back(std::move(candidates));
 		}
 	}
 
@@ -178,9 +290,8 @@ void ParallelHICANNv4SmartConfigurator::config_synapse_array(
 	                     << n_all_changed_hicanns << " HICANN(s), skipping "
 	                     << n_hicanns - n_all_changed_hicanns << " HICANN(s)");
 
-	// TODO: interleave calls to top / bottom synapse controllers
 	if (n_all_changed_hicanns != 0) {
-		for (auto syndrv : iter_all<SynapseDriverOnHICANN>()) {
+		for (auto syndrv : synapse_driver_order(getSynapseWriteOrder())) {
 			std::vector<HMF::HICANN::DecoderDoubleRow> decoder_data;
 			std::vector<HMF::HICANN::SynapseController> synapse_controllers_dec;
 			decoder_data.reserve(n_all_changed_hicanns);
@@ -188,13 +299,14 @@ void ParallelHICANNv4SmartConfigurator::config_synapse_array(
 			hicann_handles_t drv_changed_handles;
 			for (size_t ii = 0; ii != n_all_changed_hicanns; ++ii) {
 				const hicann_coord coord = all_changed_handles[ii]->coordinate();
-				const hicann_data_t old_hicann = mWrittenHICANNData.at(coord);
+				auto const old_hicann = mWrittenHICANNData.at(coord);
+				SynapseArray const& synapses = all_changed_hicanns[ii]->synapses;
 				if (!(synapse_config_mode == ConfigMode::Skip) &&
 				    (old_hicann == nullptr ||
-				     old_hicann->synapses.getDecoderDoubleRow(syndrv) !=
-				         all_changed_hicanns[ii]->synapses.getDecoderDoubleRow(syndrv))) {
-					decoder_data.push_back(
-					    all_changed_hicanns[ii]->synapses.getDecoderDoubleRow(syndrv));
+				     (all_changed_candidates[ii].decoders[syndrv.toEnum().value()] &&
+				      old_hicann->synapses().getDecoderDoubleRow(syndrv) !=
+				          synapses.getDecoderDoubleRow(syndrv)))) {
+					decoder_data.push_back(synapses.getDecoderDoubleRow(syndrv));
 					drv_changed_handles.push_back(all_changed_handles[ii]);
 					HMF::HICANN::SynapseController const synapse_controller =
 					    static_cast<HMF::HICANN::SynapseController>(
@@ -204,7 +316,7 @@ void ParallelHICANNv4SmartConfigurator::config_synapse_array(
 				}
 			}
 
-			set_decoder_double_row(drv_changed_handles, synapse_controllers_dec, syndrv, decoder_data);
+			write_decoder_double_row(drv_changed_handles, synapse_controllers_dec, syndrv, decoder_data);
 			LOG4CXX_DEBUG(
 			    getLogger(), "Smartly set decoder double row, skipped " +
 			                     std::to_string(handles.size() - drv_changed_handles.size()) +
@@ -221,12 +333,13 @@ void ParallelHICANNv4SmartConfigurator::config_synapse_array(
 				synapse_controllers_weight.reserve(n_all_changed_hicanns);
 				for (size_t ii = 0; ii != n_all_changed_hicanns; ++ii) {
 					const hicann_coord coord = all_changed_handles[ii]->coordinate();
-					const hicann_data_t old_hicann = mWrittenHICANNData.at(coord);
+					auto const old_hicann = mWrittenHICANNData.at(coord);
+					SynapseArray const& synapses = all_changed_hicanns[ii]->synapses;
 					if (!(synapse_config_mode == ConfigMode::Skip) &&
 					    (old_hicann == nullptr ||
-					     old_hicann->synapses[synrow].weights !=
-					         all_changed_hicanns[ii]->synapses[synrow].weights)) {
-						weight_data.push_back(all_changed_hicanns[ii]->synapses[synrow].weights);
+					     (all_changed_candidates[ii].weights[synrow.toEnum().value()] &&
+					      old_hicann->synapses()[synrow].weights != synapses[synrow].weights))) {
+						weight_data.push_back(synapses[synrow].weights);
 						row_changed_handles.push_back(all_changed_handles[ii]);
 					    HMF::HICANN::SynapseController const synapse_controller =
 						    static_cast<HMF::HICANN::SynapseController>(
@@ -236,7 +349,7 @@ void ParallelHICANNv4SmartConfigurator::config_synapse_array(
 					}
 				}
 
-				set_weights_row(row_changed_handles, synapse_controllers_weight, synrow, weight_data);
+				write_weights_row(row_changed_handles, synapse_controllers_weight, synrow, weight_data);
 				LOG4CXX_DEBUG(
 				    getLogger(), "Smartly configured synapse row " + std::to_string(synrow) +
 				                     ", skipped " +
@@ -265,17 +378,18 @@ void ParallelHICANNv4SmartConfigurator::config_synapse_drivers(
 	auto t = Timer::from_literal_string(__PRETTY_FUNCTION__);
 
 	const hicann_coord coord = h->coordinate();
-	const hicann_data_t old_hicann = mWrittenHICANNData.at(coord);
+	auto const old_hicann = mWrittenHICANNData.at(coord);
 
 	LOG4CXX_DEBUG(getLogger(), short_format(h->coordinate()) << ": configure synapse drivers");
+	SynapseArray const& synapses = hicann->synapses;
 	for (auto syndrv : iter_all<SynapseDriverOnHICANN>()) {
 		if (!(synapse_drv_config_mode == ConfigMode::Skip) &&
-		    (old_hicann == nullptr || old_hicann->synapses[syndrv] != hicann->synapses[syndrv])) {
+		    (old_hicann == nullptr || old_hicann->synapses()[syndrv] != synapses[syndrv])) {
 			::HMF::HICANN::set_synapse_driver(
 			    *h,
 			    static_cast< ::HMF::HICANN::SynapseController>(
 			        hicann->synapse_controllers[syndrv.toSynapseArrayOnHICANN()]),
-			    syndrv, hicann->synapses[syndrv]);
+			    syndrv, synapses[syndrv]);
 			LOG4CXX_DEBUG(getLogger(), "Configuring synapse driver");
 		} else {
 			LOG4CXX_DEBUG(getLogger(), "Skipping synapse driver configuration");
@@ -295,9 +409,9 @@ void ParallelHICANNv4SmartConfigurator::config_repeater(
 	}
 
 	const hicann_coord coord = h->coordinate();
-	const hicann_data_t old_hicann = mWrittenHICANNData.at(coord);
+	auto const old_hicann = mWrittenHICANNData.at(coord);
 	if (!(repeater_config_mode == ConfigMode::Skip) &&
-	    (old_hicann == nullptr || old_hicann->repeater != hicann->repeater)) {
+	    (old_hicann == nullptr || old_hicann->repeater() != hicann->repeater)) {
 		return ParallelHICANNv4Configurator::config_repeater(h, hicann);
 	} else {
 		LOG4CXX_INFO(getLogger(), "Skipping Repeater configuration as nothing has changed");
@@ -306,15 +420,11 @@ void ParallelHICANNv4SmartConfigurator::config_repeater(
 
 void ParallelHICANNv4SmartConfigurator::config_fpga(fpga_handle_t const& f, fpga_t const& fpga)
 {
-	if (!(reset_config_mode == ConfigMode::Skip) &&
-	    (reset_config_mode == ConfigMode::Force ||
-	     mDidFPGAConfig.find(f->coordinate()) == mDidFPGAConfig.end())) {
+	if (fpga_config_wanted(f->coordinate())) {
 		LOG4CXX_DEBUG(getLogger(), "Doing regular FPGA config");
 		ParallelHICANNv4Configurator::config_fpga(f, fpga);
 		omp_set_lock(&mLock);
 		note_fpga_config(f->coordinate());
-		// After configuring the FPGA, we have to restart the systime for all FPGAs
-		m_started_systime = false;
 		omp_unset_lock(&mLock);
 		return;
 	}
@@ -422,9 +532,7 @@ void ParallelHICANNv4SmartConfigurator::ensure_correct_l1_init_settings(
 
 void ParallelHICANNv4SmartConfigurator::prime_systime_counter(fpga_handle_t const& f)
 {
-	if (!(reset_config_mode == ConfigMode::Skip) &&
-	    (reset_config_mode == ConfigMode::Force ||
-	     !m_started_systime)) {
+	if (systime_start_wanted()) {
 		return ParallelHICANNv4Configurator::prime_systime_counter(f);
 	}
 	LOG4CXX_INFO(
@@ -434,9 +542,7 @@ void ParallelHICANNv4SmartConfigurator::prime_systime_counter(fpga_handle_t cons
 
 void ParallelHICANNv4SmartConfigurator::start_systime_counter(fpga_handle_t const& f)
 {
-	if (!(reset_config_mode == ConfigMode::Skip) &&
-	    (reset_config_mode == ConfigMode::Force ||
-	     !m_started_systime)) {
+	if (systime_start_wanted()) {
 		return ParallelHICANNv4Configurator::start_systime_counter(f);
 	}
 	LOG4CXX_INFO(
@@ -446,9 +552,7 @@ void ParallelHICANNv4SmartConfigurator::start_systime_counter(fpga_handle_t cons
 
 void ParallelHICANNv4SmartConfigurator::disable_global(fpga_handle_t const& f)
 {
-	if (!(reset_config_mode == ConfigMode::Skip) &&
-	    (reset_config_mode == ConfigMode::Force ||
-	     !m_started_systime)) {
+	if (systime_start_wanted()) {
 		return ParallelHICANNv4Configurator::disable_global(f);
 	}
 	LOG4CXX_INFO(
@@ -463,8 +567,12 @@ void ParallelHICANNv4SmartConfigurator::set_hicanns(
 	LOG4CXX_DEBUG(getLogger(), "Setting SmartConfigurators HICANN data...");
 	for (size_t ii = 0; ii != hicanns.size(); ++ii) {
 		const hicann_coord coord = handles[ii]->coordinate();
-		mWrittenHICANNData[coord] = hicann_data_t(new HICANNData);
-		mWrittenHICANNData[coord]->copy(*(hicanns[ii].get()));
+		snapshot_t& written = mWrittenHICANNData[coord];
+		// unchanged blocks are shared with the previous snapshot
+		written.reset(new HICANNDataSnapshot(*hicanns[ii], written.get()));
+		LOG4CXX_TRACE(
+		    getLogger(), short_format(coord) << ": snapshot shares " << written->shared_blocks()
+		                                     << " blocks with the previous one");
 	}
 	LOG4CXX_DEBUG(getLogger(), "Setting HICANN data complete!");
 }
@@ -511,25 +619,25 @@ bool ParallelHICANNv4SmartConfigurator::check_l1_bus_changes(hicann_coord coord,
 	}
 
 	bool change_in_l1 = false;
-	const hicann_data_t old_hicann = search_old_hicann->second;
+	auto const old_hicann = search_old_hicann->second;
 
 	if (old_hicann) {
 		// check for relevant changes in repeaters
-		change_in_l1 |= (old_hicann->repeater.mHorizontalRepeater
+		change_in_l1 |= (old_hicann->repeater().mHorizontalRepeater
 		                 != hicann->repeater.mHorizontalRepeater);
-		change_in_l1 |= (old_hicann->repeater.mVerticalRepeater
+		change_in_l1 |= (old_hicann->repeater().mVerticalRepeater
 		                 != hicann->repeater.mVerticalRepeater);
 
 		// check for changes in L1
-		change_in_l1 |= (old_hicann->layer1 != hicann->layer1);
+		change_in_l1 |= (old_hicann->layer1() != hicann->layer1);
 
 		// check for changes in switches
-		change_in_l1 |= (old_hicann->synapse_switches != hicann->synapse_switches);
-		change_in_l1 |= (old_hicann->crossbar_switches != hicann->crossbar_switches);
+		change_in_l1 |= (old_hicann->synapse_switches() != hicann->synapse_switches);
+		change_in_l1 |= (old_hicann->crossbar_switches() != hicann->crossbar_switches);
 
 		// check if dllreset or drvreset were not disabled in old configuration
-		change_in_l1 |= !old_hicann->repeater.is_drvreset_disabled();
-		change_in_l1 |= !old_hicann->repeater.is_dllreset_disabled();
+		change_in_l1 |= !old_hicann->repeater().is_drvreset_disabled();
+		change_in_l1 |= !old_hicann->repeater().is_dllreset_disabled();
 	}
 
 	return change_in_l1;
@@ -546,14 +654,15 @@ bool ParallelHICANNv4SmartConfigurator::syn_drv_locking_needed(hicann_coord coor
 	}
 
 	bool driver_changes = m_global_l1_bus_changes;
-	const hicann_data_t old_hicann = search_old_hicann->second;
+	auto const old_hicann = search_old_hicann->second;
 
 	if (old_hicann) {
+		SynapseArray const& synapses = hicann->synapses;
 		for (auto const ii : iter_all<::halco::hicann::v2::SynapseDriverOnHICANN>()) {
-			driver_changes |= (old_hicann->synapses[ii] != hicann->synapses[ii]);
+			driver_changes |= (old_hicann->synapses()[ii] != synapses[ii]);
 		}
 		// Check if dll-reset was not disabled in old configuration
-		driver_changes |= !old_hicann->synapse_controllers.is_dllreset_disabled();
+		driver_changes |= !old_hicann->synapse_controllers().is_dllreset_disabled();
 	}
 
 	return driver_changes;
@@ -595,11 +704,60 @@ void ParallelHICANNv4SmartConfigurator::note_fpga_config(
     fpga_coord const& fpga_c)
 {
 	mDidFPGAConfig.insert(fpga_c);
+	// After configuring the FPGA, we have to restart the systime for all FPGAs
+	m_started_systime = false;
 	LOG4CXX_DEBUG(
 	    getLogger(),
 	    "Noted configuration of " << fpga_c << "in SmartConfigurator.");
 }
 
+bool ParallelHICANNv4SmartConfigurator::fpga_config_wanted(fpga_coord const& fpga) const
+{
+	if (reset_config_mode == ConfigMode::Skip) {
+		return false;
+	}
+	if (reset_config_mode == ConfigMode::Force) {
+		return true;
+	}
+	omp_set_lock(&mLock);
+	bool const configured = mDidFPGAConfig.find(fpga) != mDidFPGAConfig.end();
+	omp_unset_lock(&mLock);
+	return !configured;
+}
+
+bool ParallelHICANNv4SmartConfigurator::systime_start_wanted() const
+{
+	if (reset_config_mode == ConfigMode::Skip) {
+		return false;
+	}
+	if (reset_config_mode == ConfigMode::Force) {
+		return true;
+	}
+	omp_set_lock(&mLock);
+	bool const started = m_started_systime;
+	omp_unset_lock(&mLock);
+	return !started;
+}
+
+bool ParallelHICANNv4SmartConfigurator::has_state() const
+{
+	return !mWrittenHICANNData.empty() || !mDidFPGAConfig.empty();
+}
+
+void ParallelHICANNv4SmartConfigurator::adopt_state(
+    ParallelHICANNv4SmartConfigurator const& other)
+{
+	// snapshots are immutable and can be shared
+	mWrittenHICANNData = other.mWrittenHICANNData;
+	mDidFPGAConfig = other.mDidFPGAConfig;
+	// counters of FPGAs configured earlier keep running, but whether they are still
+	// in sync can not be told from a noted state
+	m_started_systime = false;
+	LOG4CXX_DEBUG(
+	    getLogger(), "Adopted state of " << mWrittenHICANNData.size() << " HICANNs and "
+	                                     << mDidFPGAConfig.size() << " FPGAs.");
+}
+
 void ParallelHICANNv4SmartConfigurator::note_systime_start()
 {
 	m_started_systime = true;
@@ -9,6 +9,7 @@
 
 #include "hal/Handle/HICANN.h"
 #include "sthal/HICANNData.h"
+#include "sthal/HICANNDataSnapshot.h"
 #include "sthal/ParallelHICANNv4Configurator.h"
 
 extern "C"
@@ -59,11 +60,21 @@ public:
 
 	// smart functions
 	void set_hicanns(hicann_datas_t hicanns, hicann_handles_t handles);
-	// insert fpga to the set of already configured FPGAs. Not thread-safe!
+	// insert fpga to the set of already configured FPGAs, the systime of all FPGAs has to
+	// be started again afterwards. Not thread-safe!
 	void note_fpga_config(fpga_coord const& fpga);
 	// note systime start of all currently allocated FPGAs. Not thread-safe!
 	void note_systime_start();
 
+	// whether config_fpga resets and initializes the FPGA, i.e. it has not been configured
+	// before or the reset config mode is Force
+	bool fpga_config_wanted(fpga_coord const& fpga) const;
+	// whether disable_global, prime_systime_counter and start_systime_counter access the
+	// hardware, i.e. an FPGA has been configured since the last systime start or the reset
+	// config mode is Force. Thread-safe, but only meaningful once all FPGAs are configured
+	// (cf. FPGABringUp).
+	bool systime_start_wanted() const;
+
 	void set_smart();
 	void set_skip();
 	void set_force();
@@ -76,6 +87,27 @@ public:
 	ConfigMode repeater_locking_config_mode;
 	ConfigMode syn_drv_locking_config_mode;
 
+	// If set, the floating gates of HICANNs with a previously written configuration
+	// are updated row-wise in smart mode: only rows with changed values are written
+	// (cf. update_fg_rows), using the passes in fg_incremental_passes or the passes of
+	// the new configuration if empty. A change of the programming passes of a HICANN
+	// still causes a full write.
+	bool fg_incremental;
+	std::vector<FGConfig> fg_incremental_passes;
+
+#ifndef PYPLUSPLUS
+	// Rows written by config_floating_gates (VOLTAGE_ROWS, current_rows of fg and the
+	// int_op_bias row) in which the values of any block differ between written and fg
+	static row_list_t changed_fg_rows(
+	    FloatingGates const& written,
+	    FloatingGates const& fg,
+	    ::HMF::HICANN::FGRow::value_type fast_upwards_limit);
+
+	// whether the programming passes of both floating gates are equal, i.e. rows can
+	// be updated incrementally
+	static bool same_programming_passes(FloatingGates const& written, FloatingGates const& fg);
+#endif // !PYPLUSPLUS
+
 private:
 	friend class Wafer;
 	friend class boost::serialization::access;
@@ -83,19 +115,34 @@ private:
 	void serialize(Archive& ar, unsigned int const version)
 	{
 		using namespace boost::serialization;
-		ar& make_nvp("mWrittenHICANNData", mWrittenHICANNData);
+		if (version < 2) {
+			std::map<hicann_coord, hicann_data_t> written;
+			ar& make_nvp("mWrittenHICANNData", written);
+			mWrittenHICANNData.clear();
+			for (auto const& it : written) {
+				mWrittenHICANNData[it.first] =
+				    it.second ? snapshot_t(new HICANNDataSnapshot(*it.second)) : nullptr;
+			}
+		} else {
+			ar& make_nvp("mWrittenHICANNData", mWrittenHICANNData);
+		}
 		if (version == 0) {
 			ar& make_nvp("mDidFPGAReset", mDidFPGAConfig);
 		}
 		if (version > 0) {
 			ar& make_nvp("mDidFPGAConfig", mDidFPGAConfig);
-			ar& make_nvp("m_started_systime", m_started_systime);
+		}
+		if (version == 1 || version == 2) {
+			bool started_systime;
+			ar& make_nvp("m_started_systime", started_systime);
 		}
 		// m_global_l1_bus_changes is not serialized since it is determined during
-		// each configuration
+		// each configuration, m_started_systime since the systime counters have to be
+		// restarted by each process (cf. adopt_state())
 	}
-	// pointer to the Wafers HICANN data that was written previously
-	std::map<hicann_coord, hicann_data_t> mWrittenHICANNData;
+	typedef boost::shared_ptr<HICANNDataSnapshot> snapshot_t;
+	// snapshot of the Wafers HICANN data that was written previously
+	std::map<hicann_coord, snapshot_t> mWrittenHICANNData;
 	std::set<fpga_coord> mDidFPGAConfig;
 
 	// global variable to check if relocking is needed. A change on a single HICANN may requires
@@ -108,7 +155,15 @@ private:
 
 	// need lock since access to mWrittenHICANNData and mDidFPGAConfig can be
 	// multithreaded
-	omp_lock_t mLock;
+	mutable omp_lock_t mLock;
+
+	// whether any configuration has been noted yet
+	bool has_state() const;
+
+	// take over the noted configuration of other, e.g. a state restored from disk
+	// (cf. SmartConfiguratorStateStore). The systime counters are not taken over,
+	// they are always started again. Not thread-safe!
+	void adopt_state(ParallelHICANNv4SmartConfigurator const& other);
 
 	// determines if changes on a single HICANN could affect the global locking of repeaters
 	bool check_l1_bus_changes(hicann_coord coord, hicann_data_t const& hicann) const;
@@ -132,4 +187,4 @@ private:
 
 } // end namespace sthal
 
-BOOST_CLASS_VERSION(sthal::ParallelHICANNv4SmartConfigurator, 1)
+BOOST_CLASS_VERSION(sthal::ParallelHICANNv4SmartConfigurator, 3)
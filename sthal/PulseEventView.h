@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "hal/FPGAContainer.h"
+
+namespace sthal {
+
+/**
+ * @brief Read-only view of a contiguous range of pulse events.
+ * The view does not own the events, it is invalidated by any modification of
+ * the container it was obtained from.
+ */
+class PulseEventView
+{
+public:
+	typedef ::HMF::FPGA::PulseEvent value_type;
+	typedef value_type const* const_iterator;
+
+	PulseEventView() : m_begin(nullptr), m_end(nullptr) {}
+	PulseEventView(const_iterator begin, const_iterator end) : m_begin(begin), m_end(end) {}
+
+	const_iterator begin() const { return m_begin; }
+	const_iterator end() const { return m_end; }
+
+	size_t size() const { return static_cast<size_t>(m_end - m_begin); }
+	bool empty() const { return m_begin == m_end; }
+
+	value_type const& operator[](size_t const ii) const { return m_begin[ii]; }
+
+	/// copy of the viewed pulse events
+	std::vector<value_type> copy() const { return std::vector<value_type>(m_begin, m_end); }
+
+private:
+	const_iterator m_begin;
+	const_iterator m_end;
+};
+
+} // end namespace sthal
@@ -0,0 +1,109 @@
+#include "sthal/ReceivedSpikeStatistics.h"
+
+#include <algorithm>
+#include <numeric>
+#include <ostream>
+
+#include "halco/common/iter_all.h"
+
+#include "sthal/FPGA.h"
+
+using namespace ::halco::hicann::v2;
+using namespace ::halco::common;
+
+namespace sthal {
+
+ReceivedSpikeStatistics::ReceivedSpikeStatistics()
+	: total(0), background(0), dropped(0), first_time(0), last_time(0), run_time_in_us(0)
+{
+	for (auto& dnc : counts) {
+		for (auto& hicann : dnc) {
+			hicann.fill(0);
+		}
+	}
+}
+
+double ReceivedSpikeStatistics::background_fraction() const
+{
+	return total ? double(background) / total : 0.;
+}
+
+ReceivedSpikeStatistics::count_t ReceivedSpikeStatistics::count(
+    dnc_coord const& dnc, hicann_on_dnc_coord const& hicann) const
+{
+	auto const& c = counts[dnc][hicann];
+	return std::accumulate(c.begin(), c.end(), count_t(0));
+}
+
+double ReceivedSpikeStatistics::rate(
+    dnc_coord const& dnc, hicann_on_dnc_coord const& hicann) const
+{
+	return run_time_in_us > 0 ? count(dnc, hicann) / (run_time_in_us * 1e-6) : 0.;
+}
+
+double ReceivedSpikeStatistics::utilization(
+    dnc_coord const& dnc, hicann_on_dnc_coord const& hicann) const
+{
+	return rate(dnc, hicann) / FPGA::gbitlink_max_throughput;
+}
+
+ReceivedSpikeStatistics ReceivedSpikeStatistics::collect(
+    std::vector< ::HMF::FPGA::PulseEvent>& events, bool const drop_background,
+    double const run_time_in_us)
+{
+	// L1Address(0) is reserved for background events
+	::HMF::HICANN::L1Address const bkg_address(0);
+
+	ReceivedSpikeStatistics stats;
+	stats.run_time_in_us = run_time_in_us;
+	stats.total = events.size();
+	if (!events.empty()) {
+		stats.first_time = events.front().getTime();
+		stats.last_time = events.front().getTime();
+	}
+
+	auto out = events.begin();
+	for (auto it = events.begin(); it != events.end(); ++it) {
+		// the trace is not necessarily ordered by time
+		uint64_t const time = it->getTime();
+		stats.first_time = std::min(stats.first_time, time);
+		stats.last_time = std::max(stats.last_time, time);
+		++stats.counts[dnc_coord(Enum(it->getDncAddress().value()))][it->getChipAddress()]
+		              [dnc_merger_coord(it->getChannel().value())];
+		if (it->getNeuronAddress() == bkg_address) {
+			++stats.background;
+			if (drop_background) {
+				continue;
+			}
+		}
+		if (out != it) {
+			*out = *it;
+		}
+		++out;
+	}
+	stats.dropped = std::distance(out, events.end());
+	events.erase(out, events.end());
+	return stats;
+}
+
+bool operator==(ReceivedSpikeStatistics const& a, ReceivedSpikeStatistics const& b)
+{
+	return a.total == b.total && a.background == b.background && a.dropped == b.dropped &&
+	       a.first_time == b.first_time && a.last_time == b.last_time &&
+	       a.run_time_in_us == b.run_time_in_us && a.counts == b.counts;
+}
+
+bool operator!=(ReceivedSpikeStatistics const& a, ReceivedSpikeStatistics const& b)
+{
+	return !(a == b);
+}
+
+std::ostream& operator<<(std::ostream& out, ReceivedSpikeStatistics const& obj)
+{
+	out << "ReceivedSpikeStatistics(total=" << obj.total << ", background=" << obj.background
+	    << ", dropped=" << obj.dropped << ", first_time=" << obj.first_time
+	    << ", last_time=" << obj.last_time << ")";
+	return out;
+}
+
+} // end namespace sthal
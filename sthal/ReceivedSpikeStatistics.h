@@ -0,0 +1,100 @@
+#pragma once
+
+#include <iosfwd>
+#include <vector>
+
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/version.hpp>
+
+#include "halco/common/typed_array.h"
+#include "halco/hicann/v2/external.h"
+#include "halco/hicann/v2/l1.h"
+#include "hal/FPGAContainer.h"
+
+namespace sthal {
+
+/**
+ * @brief Statistics of the pulse events received by one FPGA in an experiment run.
+ * Collected in a single pass over the trace by #collect(), which optionally also
+ * removes background events (L1Address(0)) in place.
+ * @note Counts include background events that have been dropped, i.e. they describe
+ *       the trace as read from the FPGA.
+ */
+struct ReceivedSpikeStatistics
+{
+	typedef ::halco::hicann::v2::DNCOnFPGA dnc_coord;
+	typedef ::halco::hicann::v2::HICANNOnDNC hicann_on_dnc_coord;
+	typedef ::halco::hicann::v2::GbitLinkOnHICANN dnc_merger_coord;
+	typedef uint64_t count_t;
+	typedef halco::common::typed_array<count_t, dnc_merger_coord> merger_counts_t;
+	typedef halco::common::typed_array<merger_counts_t, hicann_on_dnc_coord> hicann_counts_t;
+	typedef halco::common::typed_array<hicann_counts_t, dnc_coord> dnc_counts_t;
+
+	ReceivedSpikeStatistics();
+
+	/// number of received events
+	count_t total;
+	/// number of received background events (L1Address(0))
+	count_t background;
+	/// number of background events removed from the trace
+	count_t dropped;
+	/// smallest and largest timestamp of all events in FPGA clock cycles, only valid if
+	/// total > 0
+	uint64_t first_time;
+	uint64_t last_time;
+	/// duration of the experiment run in microseconds, used for rates
+	double run_time_in_us;
+	/// received events per DNC merger, i.e. counts[dnc][hicann][merger] as in the
+	/// addresses of the pulse events
+	dnc_counts_t counts;
+
+	/// fraction of background events, 0 if no event has been received
+	double background_fraction() const;
+	/// number of events received from the given HICANN
+	count_t count(dnc_coord const& dnc, hicann_on_dnc_coord const& hicann) const;
+	/// event rate of the given HICANN in 1/s
+	double rate(dnc_coord const& dnc, hicann_on_dnc_coord const& hicann) const;
+	/// event rate of the given HICANN relative to FPGA::gbitlink_max_throughput
+	double utilization(dnc_coord const& dnc, hicann_on_dnc_coord const& hicann) const;
+
+#ifndef PYPLUSPLUS
+	/**
+	 * @brief Collect statistics of the given trace in a single pass.
+	 * @param events Trace as read from the FPGA, background events are removed
+	 *               in place (preserving order) if drop_background is set.
+	 */
+	static ReceivedSpikeStatistics collect(
+	    std::vector< ::HMF::FPGA::PulseEvent>& events, bool drop_background, double run_time_in_us);
+#endif // !PYPLUSPLUS
+
+	friend bool operator==(ReceivedSpikeStatistics const& a, ReceivedSpikeStatistics const& b);
+	friend bool operator!=(ReceivedSpikeStatistics const& a, ReceivedSpikeStatistics const& b);
+
+private:
+	friend class boost::serialization::access;
+	template <typename Archiver>
+	void serialize(Archiver& ar, unsigned int const version)
+	{
+		using boost::serialization::make_nvp;
+		ar & make_nvp("total", total)
+		   & make_nvp("background", background)
+		   & make_nvp("dropped", dropped)
+		   & make_nvp("first_time", first_time)
+		   & make_nvp("last_time", last_time)
+		   & make_nvp("run_time_in_us", run_time_in_us);
+		if (version < 1) {
+			// counts of the same HICANNOnDNC on different DNCs were merged, they can
+			// not be attributed to a DNC anymore
+			hicann_counts_t merged;
+			ar & make_nvp("counts", merged);
+		} else {
+			ar & make_nvp("counts", counts);
+		}
+	}
+};
+
+std::ostream& operator<<(std::ostream& out, ReceivedSpikeStatistics const& obj);
+
+} // end namespace sthal
+
+BOOST_CLASS_VERSION(sthal::ReceivedSpikeStatistics, 1)
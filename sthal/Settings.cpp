@@ -37,7 +37,12 @@ Settings::CfgStages::CfgStages() :
 	       ConfigurationStage::TIMING_UNCRITICAL,
 	       ConfigurationStage::LOCKING_REPEATER_BLOCKS,
 	       ConfigurationStage::LOCKING_SYNAPSE_DRIVERS,
-	       ConfigurationStage::NEURONS})
+	       ConfigurationStage::NEURONS}),
+	// repeaters lock to L1 signals of other HICANNs, synapse drivers to locked repeaters
+	l1_dependencies({{ConfigurationStage::LOCKING_REPEATER_BLOCKS,
+	                  {ConfigurationStage::TIMING_UNCRITICAL}},
+	                 {ConfigurationStage::LOCKING_SYNAPSE_DRIVERS,
+	                  {ConfigurationStage::LOCKING_REPEATER_BLOCKS}}})
 {}
 
 Settings::Settings() :
@@ -53,6 +58,9 @@ Settings::Settings() :
 				? std::getenv("STHAL_YAML_HARDWARE_DATABASE_PATH")
 				: "/wang/data/bss-hwdb/db.yaml")),
 	datadir(getenv_or_default("NMPM_DATADIR", DATADIR) + "/sthal/"),
+	smart_configurator_state_dir(getenv_or_default("STHAL_SMART_CONFIGURATOR_STATE_DIR", "")),
+	trust_smart_configurator_state(
+		getenv_or_default("STHAL_TRUST_SMART_CONFIGURATOR_STATE", "0") != "0"),
 	crossbar_switches(),
 	synapse_switches(),
 	hicann_checks_mode(HICANNChecksMode::Check),
@@ -27,6 +27,15 @@ public:
 	std::string datadir; //>! path for read-only architecture-independent data,
 	                     //>! can be overwritten by NMPM_DATADIR (sthal will be appended)
 
+	std::string smart_configurator_state_dir; //>! directory for persistent smart configurator
+	                                          //>! states (one file per wafer), disabled if empty,
+	                                          //>! can be set by STHAL_SMART_CONFIGURATOR_STATE_DIR
+
+	bool trust_smart_configurator_state; //>! take over the stored smart configurator state in a new
+	                                     //>! process, i.e. skip the FPGA reset and unchanged HICANN
+	                                     //>! blocks. Only valid if nobody else touched the hardware
+	                                     //>! since, can be set by STHAL_TRUST_SMART_CONFIGURATOR_STATE=1
+
 	struct CrossbarSwitches
 	{
 		CrossbarSwitches(
@@ -69,8 +78,15 @@ public:
 
 	struct CfgStages {
 		CfgStages();
+		/// settle time after a stage has finished on an FPGA, before stages
+		/// depending on it start (on this or L1-coupled FPGAs)
 		std::map<ConfigurationStage, size_t> sleeps; // in ms
+		/// order of the stages on each FPGA
 		std::vector<ConfigurationStage> order;
+		/// stage -> stages that have to be finished on all FPGAs coupled to an FPGA via
+		/// layer 1 (adjacent allocated HICANNs) before the stage may start on it,
+		/// cf. ConfigurationScheduler
+		std::map<ConfigurationStage, std::vector<ConfigurationStage> > l1_dependencies;
 	};
 
 	CfgStages configuration_stages;
@@ -0,0 +1,128 @@
+#include "sthal/SmartConfiguratorStateStore.h"
+
+#include <sstream>
+#include <stdexcept>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <log4cxx/logger.h>
+
+#include "sthal/ContentHash.h"
+#include "sthal/ParallelHICANNv4SmartConfigurator.h"
+
+namespace sthal {
+
+namespace {
+
+log4cxx::LoggerPtr logger = log4cxx::Logger::getLogger("sthal.SmartConfiguratorStateStore");
+
+uint64_t string_hash(std::string const& str)
+{
+	HashStreamBuffer buffer;
+	buffer.sputn(str.data(), str.size());
+	return buffer.hash();
+}
+
+} // anonymous namespace
+
+bool operator==(SmartConfiguratorStateStore::Key const& a, SmartConfiguratorStateStore::Key const& b)
+{
+	return a.fpga_id == b.fpga_id && a.config_hash == b.config_hash;
+}
+
+bool operator!=(SmartConfiguratorStateStore::Key const& a, SmartConfiguratorStateStore::Key const& b)
+{
+	return !(a == b);
+}
+
+SmartConfiguratorStateStore::SmartConfiguratorStateStore(
+	std::string const& directory, wafer_coord const& wafer) :
+	m_directory(directory),
+	m_wafer(wafer)
+{
+	if (m_directory.empty()) {
+		throw std::invalid_argument("SmartConfiguratorStateStore: empty directory");
+	}
+}
+
+SmartConfiguratorStateStore::Key SmartConfiguratorStateStore::key(Status const& status)
+{
+	Key key;
+	std::copy(status.fpga_id.begin(), status.fpga_id.end(), key.fpga_id.begin());
+
+	uint64_t hash = string_hash(status.git_rev_halbe);
+	hash = hash_combine(hash, string_hash(status.git_rev_hicann_system));
+	hash = hash_combine(hash, string_hash(status.git_rev_sthal));
+	for (auto const rev : status.fpga_rev) {
+		hash = hash_combine(hash, rev);
+	}
+	key.config_hash = hash;
+	return key;
+}
+
+std::string SmartConfiguratorStateStore::path() const
+{
+	std::stringstream filename;
+	filename << "smart_configurator_wafer_" << m_wafer.value() << ".bin";
+	return (boost::filesystem::path(m_directory) / filename.str()).string();
+}
+
+bool SmartConfiguratorStateStore::load(
+	Key const& key, ParallelHICANNv4SmartConfigurator& configurator) const
+{
+	boost::filesystem::path const filename(path());
+	if (!boost::filesystem::exists(filename)) {
+		LOG4CXX_DEBUG(logger, "No smart configurator state in " << filename);
+		return false;
+	}
+
+	try {
+		boost::filesystem::ifstream stream(filename, std::ios::binary);
+		boost::archive::binary_iarchive ar(stream);
+		Key stored;
+		ar >> stored;
+		if (stored != key) {
+			LOG4CXX_INFO(
+				logger, "Ignoring smart configurator state in "
+				            << filename << ": stored for different hardware or software");
+			return false;
+		}
+		ar >> configurator;
+	} catch (std::exception const& e) {
+		LOG4CXX_WARN(
+			logger, "Ignoring unreadable smart configurator state in " << filename << ": "
+			                                                             << e.what());
+		return false;
+	}
+	LOG4CXX_INFO(logger, "Loaded smart configurator state from " << filename);
+	return true;
+}
+
+void SmartConfiguratorStateStore::save(
+	Key const& key, ParallelHICANNv4SmartConfigurator const& configurator) const
+{
+	boost::filesystem::path const filename(path());
+	boost::filesystem::create_directories(filename.parent_path());
+
+	// write to a temporary file first, so an interrupted save never leaves a
+	// truncated state behind
+	boost::filesystem::path const tmp =
+		filename.parent_path() / boost::filesystem::unique_path(".%%%%-%%%%-%%%%-%%%%.tmp");
+	{
+		boost::filesystem::ofstream stream(tmp, std::ios::binary);
+		boost::archive::binary_oarchive ar(stream);
+		ar << key << configurator;
+	}
+	boost::filesystem::rename(tmp, filename);
+	LOG4CXX_INFO(logger, "Saved smart configurator state to " << filename);
+}
+
+void SmartConfiguratorStateStore::invalidate() const
+{
+	boost::filesystem::remove(path());
+}
+
+} // end namespace sthal
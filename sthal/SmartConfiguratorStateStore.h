@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include <boost/serialization/nvp.hpp>
+#include "boost/serialization/array.h"
+
+#include "halco/hicann/v2/external.h"
+
+#include "sthal/Status.h"
+
+namespace sthal {
+
+class ParallelHICANNv4SmartConfigurator;
+
+/// Persistent state of a ParallelHICANNv4SmartConfigurator, one file per wafer in
+/// a directory (cf. Settings::smart_configurator_state_dir).
+///
+/// A state is only valid for the hardware it was written to and for the software
+/// that wrote it: it is stored together with a key of the FPGA hardware ids and a
+/// hash of the software and FPGA bitfile revisions (cf. Status) and only loaded if
+/// the key matches. The key can not tell whether the hardware has been reset since,
+/// Wafer only takes over stored states if Settings::trust_smart_configurator_state
+/// is set. The systime state is not stored.
+class SmartConfiguratorStateStore
+{
+public:
+	typedef ::halco::hicann::v2::Wafer wafer_coord;
+	typedef ::halco::hicann::v2::FPGAOnWafer fpga_coord;
+
+	struct Key
+	{
+		std::array<uint64_t, fpga_coord::size> fpga_id;
+		uint64_t config_hash;
+
+		friend bool operator==(Key const& a, Key const& b);
+		friend bool operator!=(Key const& a, Key const& b);
+
+	private:
+		friend class boost::serialization::access;
+		template <typename Archiver>
+		void serialize(Archiver& ar, unsigned int const)
+		{
+			using boost::serialization::make_nvp;
+			ar & make_nvp("fpga_id", fpga_id)
+			   & make_nvp("config_hash", config_hash);
+		}
+	};
+
+	SmartConfiguratorStateStore(std::string const& directory, wafer_coord const& wafer);
+
+	/// Key of the hardware and software described by status
+	static Key key(Status const& status);
+
+	/// file holding the state of the wafer
+	std::string path() const;
+
+	/// Loads the stored state into configurator if it exists and was stored with key.
+	/// Returns whether the state was loaded.
+	bool load(Key const& key, ParallelHICANNv4SmartConfigurator& configurator) const;
+
+	/// Stores the state of configurator with key, replacing the previous one
+	void save(Key const& key, ParallelHICANNv4SmartConfigurator const& configurator) const;
+
+	/// Removes the stored state, e.g. because the hardware is about to be modified
+	void invalidate() const;
+
+private:
+	std::string m_directory;
+	wafer_coord m_wafer;
+};
+
+} // end namespace sthal
@@ -0,0 +1,101 @@
+#include "sthal/SpikeTrain.h"
+
+#include <algorithm>
+
+#include "sthal/FPGA.h"
+
+namespace sthal {
+
+SpikeTrain::SpikeTrain()
+{
+}
+
+SpikeTrain::SpikeTrain(SpikeVector const& spikes)
+{
+	reserve(spikes.size());
+	for (auto const& spike : spikes) {
+		push_back(spike.addr, tick_type(spike.time * FPGA::dnc_freq));
+	}
+}
+
+void SpikeTrain::reserve(size_t const n)
+{
+	m_times.reserve(n);
+	m_addrs.reserve(n);
+}
+
+void SpikeTrain::push_back(L1Address const& addr, tick_type const time)
+{
+	m_times.push_back(time);
+	m_addrs.push_back(addr.value());
+}
+
+void SpikeTrain::clear()
+{
+	m_times.clear();
+	m_addrs.clear();
+}
+
+size_t SpikeTrain::size() const
+{
+	return m_times.size();
+}
+
+bool SpikeTrain::empty() const
+{
+	return m_times.empty();
+}
+
+std::vector<SpikeTrain::tick_type> const& SpikeTrain::times() const
+{
+	return m_times;
+}
+
+std::vector<SpikeTrain::address_type> const& SpikeTrain::addrs() const
+{
+	return m_addrs;
+}
+
+std::vector<double> SpikeTrain::times_in_s() const
+{
+	double const t = 1.0 / FPGA::dnc_freq;
+	std::vector<double> result(m_times.size());
+	std::transform(m_times.begin(), m_times.end(), result.begin(), [t](tick_type time) {
+		return time * t;
+	});
+	return result;
+}
+
+Spike SpikeTrain::at(size_t const ii) const
+{
+	return Spike(L1Address(m_addrs.at(ii)), m_times.at(ii) / FPGA::dnc_freq);
+}
+
+SpikeVector SpikeTrain::toSpikeVector() const
+{
+	double const t = 1.0 / FPGA::dnc_freq;
+	SpikeVector result;
+	result.reserve(size());
+	for (size_t ii = 0; ii < size(); ++ii) {
+		result.push_back(Spike(L1Address(m_addrs[ii]), m_times[ii] * t));
+	}
+	return result;
+}
+
+bool operator==(SpikeTrain const& a, SpikeTrain const& b)
+{
+	return a.m_times == b.m_times && a.m_addrs == b.m_addrs;
+}
+
+bool operator!=(SpikeTrain const& a, SpikeTrain const& b)
+{
+	return !(a == b);
+}
+
+std::ostream& operator<<(std::ostream& out, SpikeTrain const& obj)
+{
+	out << "SpikeTrain(" << obj.size() << " spikes)";
+	return out;
+}
+
+} // end namespace sthal
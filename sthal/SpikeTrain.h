@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include "sthal/Spike.h"
+
+namespace sthal {
+
+/**
+ * @brief Spike train in columnar layout.
+ * Spike times and addresses are stored in two separate contiguous arrays, times are
+ * kept as integer FPGA clock cycles and only converted to seconds on request.
+ * In python `times` and `addrs` are read-only numpy views onto this memory.
+ */
+class SpikeTrain
+{
+public:
+	typedef ::HMF::HICANN::L1Address L1Address;
+	typedef uint64_t tick_type;
+	typedef uint16_t address_type;
+
+	SpikeTrain();
+	explicit SpikeTrain(SpikeVector const& spikes);
+
+	void reserve(size_t n);
+	void push_back(L1Address const& addr, tick_type time);
+	void clear();
+
+	size_t size() const;
+	bool empty() const;
+
+	/// spike times in FPGA clock cycles
+	std::vector<tick_type> const& times() const;
+	/// spike addresses
+	std::vector<address_type> const& addrs() const;
+
+	/// spike times in seconds
+	std::vector<double> times_in_s() const;
+
+	Spike at(size_t ii) const;
+	SpikeVector toSpikeVector() const;
+
+	friend bool operator==(SpikeTrain const& a, SpikeTrain const& b);
+	friend bool operator!=(SpikeTrain const& a, SpikeTrain const& b);
+
+private:
+	std::vector<tick_type> m_times;
+	std::vector<address_type> m_addrs;
+
+	friend class boost::serialization::access;
+	template<typename Archiver>
+	void serialize(Archiver & ar, unsigned int const)
+	{
+		using boost::serialization::make_nvp;
+		ar & make_nvp("times", m_times)
+		   & make_nvp("addrs", m_addrs);
+	}
+};
+
+std::ostream& operator<<(std::ostream& out, SpikeTrain const& obj);
+
+} // end namespace sthal
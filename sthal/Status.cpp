@@ -54,6 +54,15 @@ std::ostream & operator<<(std::ostream & stream, const Status & st)
 		}
 	}
 	out << "\n";
+	out << "Received spikes: ";
+	for (auto it : pythonic::enumerate(st.received_spikes)) {
+		auto const& stats = it.second;
+		if (stats.total) {
+			out << "FPGA " << it.first << ": " << stats.total << " events, "
+			    << stats.background << " background, " << stats.dropped << " dropped; ";
+		}
+	}
+	out << "\n";
 	out << "ADCChannels:" << std::endl;
 	auto empty = HMF::ADC::USBSerial();
 	for (auto it : st.adc_channels) {
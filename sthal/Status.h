@@ -5,6 +5,8 @@
 #include "hal/ADC/USBSerial.h"
 #include "halco/hicann/v2/external.h"
 
+#include "sthal/ReceivedSpikeStatistics.h"
+
 namespace sthal {
 
 struct ADCChannel {
@@ -43,6 +45,10 @@ struct Status
 	typedef halco::common::typed_array< hicann_drops_t, fpga_coord > fpga_drops_t;
 	fpga_drops_t fpga_drops;
 
+	/// statistics of the spikes received in the last experiment run
+	typedef halco::common::typed_array<ReceivedSpikeStatistics, fpga_coord> received_spikes_t;
+	received_spikes_t received_spikes;
+
 	// adc_channels[dnc_id][analog]
 	typedef halco::common::typed_array<ADCChannel, ::halco::hicann::v2::AnalogOnHICANN> dual_channel_t;
 	typedef halco::common::typed_array<dual_channel_t, ::halco::hicann::v2::DNCOnWafer> adc_channels_t;
@@ -80,6 +86,9 @@ private:
 			ar  & make_nvp("fpga_drops", fpga_drops);
 		}
 		ar & make_nvp("adc_channels", adc_channels);
+		if (version >= 3) {
+			ar & make_nvp("received_spikes", received_spikes);
+		}
 	}
 };
 
@@ -88,4 +97,4 @@ std::ostream& operator<<(std::ostream& out, ADCChannel const& obj);
 
 } // end namespace sthal
 
-BOOST_CLASS_VERSION(sthal::Status, (::halco::hicann::v2::FPGAOnWafer::size == 12 ? 0 : 2))
+BOOST_CLASS_VERSION(sthal::Status, (::halco::hicann::v2::FPGAOnWafer::size == 12 ? 0 : 3))
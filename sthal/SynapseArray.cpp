@@ -1,10 +1,292 @@
 #include "SynapseArray.h"
+
+#include <atomic>
+#include <tuple>
+
 #include "halco/common/iter_all.h"
+#include "sthal/ContentHash.h"
 
 namespace sthal {
 
 const size_t SynapseArray::no_drivers;
 const size_t SynapseArray::no_lines;
+const size_t SynapseArray::packed_bits;
+const size_t SynapseRowLeases::no_rows;
+
+namespace {
+
+uint64_t next_history()
+{
+	// 0 is never used, so it can denote "no history"
+	static std::atomic<uint64_t> histories(0);
+	return ++histories;
+}
+
+} // anonymous namespace
+
+SynapseRowLeases::SynapseRowLeases() : m_total(0), m_any_released(false)
+{
+	m_count.fill(0);
+	m_released.fill(false);
+}
+
+SynapseRowLeases::SynapseRowLeases(SynapseRowLeases const&) : SynapseRowLeases()
+{
+}
+
+SynapseRowLeases& SynapseRowLeases::operator=(SynapseRowLeases const&)
+{
+	// proxies refer to the storage of the assigned-to array
+	return *this;
+}
+
+void SynapseRowLeases::acquire(size_t const row)
+{
+	++m_count[row];
+	++m_total;
+}
+
+void SynapseRowLeases::release(size_t const row)
+{
+	--m_count[row];
+	--m_total;
+	m_released[row] = true;
+	m_any_released = true;
+}
+
+bool SynapseRowLeases::any() const
+{
+	return m_total != 0 || m_any_released;
+}
+
+bool SynapseRowLeases::leased(size_t const row) const
+{
+	return m_count[row] != 0 || m_released[row];
+}
+
+void SynapseRowLeases::reset_released()
+{
+	if (m_any_released) {
+		m_released.fill(false);
+		m_any_released = false;
+	}
+}
+
+SynapseRowLease::SynapseRowLease() : m_leases(nullptr), m_row(0)
+{
+}
+
+SynapseRowLease::SynapseRowLease(SynapseRowLeases& leases, size_t const row) :
+	m_leases(&leases), m_row(row)
+{
+	m_leases->acquire(m_row);
+}
+
+SynapseRowLease::SynapseRowLease(SynapseRowLease const& other) :
+	m_leases(other.m_leases), m_row(other.m_row)
+{
+	if (m_leases) {
+		m_leases->acquire(m_row);
+	}
+}
+
+SynapseRowLease& SynapseRowLease::operator=(SynapseRowLease const& other)
+{
+	if (other.m_leases) {
+		other.m_leases->acquire(other.m_row);
+	}
+	if (m_leases) {
+		m_leases->release(m_row);
+	}
+	m_leases = other.m_leases;
+	m_row = other.m_row;
+	return *this;
+}
+
+SynapseRowLease::~SynapseRowLease()
+{
+	if (m_leases) {
+		m_leases->release(m_row);
+	}
+}
+
+SynapseArray::Generations::Generations()
+{
+	renew();
+}
+
+SynapseArray::Generations::Generations(Generations const&)
+{
+	renew();
+}
+
+SynapseArray::Generations& SynapseArray::Generations::operator=(Generations const&)
+{
+	renew();
+	return *this;
+}
+
+void SynapseArray::Generations::renew()
+{
+	history = next_history();
+	current = 0;
+	drivers.fill(0);
+	decoders.fill(0);
+	weights.fill(0);
+	hash_valid = false;
+	hashed = 0;
+	hash = 0;
+}
+
+void SynapseArray::Generations::touch_driver(driver_coordinate const& driver)
+{
+	drivers[driver.line()] = ++current;
+}
+
+void SynapseArray::Generations::touch_decoder(driver_coordinate const& driver)
+{
+	decoders[driver.line()] = ++current;
+}
+
+void SynapseArray::Generations::touch_row(row_coordinate const& row)
+{
+	++current;
+	decoders[row.toSynapseDriverOnHICANN().line()] = current;
+	weights[row.toEnum().value()] = current;
+}
+
+void SynapseArray::Generations::touch_all()
+{
+	++current;
+	drivers.fill(current);
+	decoders.fill(current);
+	weights.fill(current);
+}
+
+uint64_t SynapseArray::history() const
+{
+	return m_generations.history;
+}
+
+SynapseArray::generation_type SynapseArray::generation() const
+{
+	stamp_leased_rows();
+	return m_generations.current;
+}
+
+void SynapseArray::stamp_leased_rows() const
+{
+	if (!m_leases.any()) {
+		return;
+	}
+	for (auto const& row : halco::common::iter_all<row_coordinate>()) {
+		if (m_leases.leased(row.toEnum().value())) {
+			m_generations.touch_row(row);
+		}
+	}
+	m_leases.reset_released();
+}
+
+uint64_t SynapseArray::driver_hash(driver_coordinate const& driver) const
+{
+	using namespace halco::hicann::v2;
+	size_t const line = driver.line();
+	HashStreamBuffer buffer;
+	{
+		std::ostream stream(&buffer);
+		boost::archive::binary_oarchive ar(
+			stream, boost::archive::no_header | boost::archive::no_tracking);
+		ar << drivers[line] << decoders[line];
+		for (auto side : halco::common::iter_all<halco::common::SideVertical>()) {
+			ar << weights[row_coordinate(driver, RowOnSynapseDriver(side))];
+		}
+	}
+	return hash_combine(line, buffer.hash());
+}
+
+uint64_t SynapseArray::content_hash() const
+{
+	using namespace halco::hicann::v2;
+	stamp_leased_rows();
+	Generations& g = m_generations;
+	// references to drivers are not tracked, compare them to the hashed ones
+	for (auto const& driver : halco::common::iter_all<driver_coordinate>()) {
+		size_t const line = driver.line();
+		if (g.hash_valid && g.drivers[line] <= g.hashed && drivers[line] != g.hashed_drivers[line]) {
+			g.drivers[line] = ++g.current;
+		}
+	}
+	if (g.hash_valid && g.hashed == g.current) {
+		return g.hash;
+	}
+
+	if (!g.hash_valid) {
+		g.hash = 0;
+	}
+	for (auto const& driver : halco::common::iter_all<driver_coordinate>()) {
+		size_t const line = driver.line();
+		bool stale = !g.hash_valid || g.drivers[line] > g.hashed || g.decoders[line] > g.hashed;
+		for (auto side : halco::common::iter_all<halco::common::SideVertical>()) {
+			row_coordinate const row(driver, RowOnSynapseDriver(side));
+			stale |= g.weights[row.toEnum().value()] > g.hashed;
+		}
+		if (!stale) {
+			continue;
+		}
+		// the total is the XOR of all driver hashes, so single drivers can be replaced
+		uint64_t const hash = driver_hash(driver);
+		if (g.hash_valid) {
+			g.hash ^= g.driver_hashes[line];
+		}
+		g.hash ^= hash;
+		g.driver_hashes[line] = hash;
+		g.hashed_drivers[line] = drivers[line];
+	}
+	g.hash_valid = true;
+	g.hashed = g.current;
+	return g.hash;
+}
+
+uint64_t content_hash(SynapseArray const& synapses)
+{
+	return synapses.content_hash();
+}
+
+std::vector<SynapseArray::driver_coordinate> SynapseArray::changed_drivers(
+	generation_type since) const
+{
+	stamp_leased_rows();
+	std::vector<driver_coordinate> changed;
+	for (auto const& driver : halco::common::iter_all<driver_coordinate>()) {
+		if (m_generations.drivers[driver.line()] > since)
+			changed.push_back(driver);
+	}
+	return changed;
+}
+
+std::vector<SynapseArray::driver_coordinate> SynapseArray::changed_decoders(
+	generation_type since) const
+{
+	stamp_leased_rows();
+	std::vector<driver_coordinate> changed;
+	for (auto const& driver : halco::common::iter_all<driver_coordinate>()) {
+		if (m_generations.decoders[driver.line()] > since)
+			changed.push_back(driver);
+	}
+	return changed;
+}
+
+std::vector<SynapseArray::row_coordinate> SynapseArray::changed_weights(
+	generation_type since) const
+{
+	stamp_leased_rows();
+	std::vector<row_coordinate> changed;
+	for (auto const& row : halco::common::iter_all<row_coordinate>()) {
+		if (m_generations.weights[row.toEnum().value()] > since)
+			changed.push_back(row);
+	}
+	return changed;
+}
 
 bool operator==(const SynapseArray & a, const SynapseArray & b)
 {
@@ -20,6 +302,7 @@ bool operator!=(const SynapseArray & a, const SynapseArray & b)
 
 void SynapseArray::clear_drivers()
 {
+	m_generations.touch_all();
 	std::fill(drivers.begin(), drivers.end(), driver_type());
 }
 
@@ -51,6 +334,7 @@ void SynapseArray::set_all(::HMF::HICANN::SynapseDecoder decoder, ::HMF::HICANN:
 
 void SynapseArray::set_all_decoders(::HMF::HICANN::SynapseDecoder decoder)
 {
+	m_generations.touch_all();
 	for (auto & doublerow : decoders)
 	{
 		for (auto & row : doublerow)
@@ -62,12 +346,59 @@ void SynapseArray::set_all_decoders(::HMF::HICANN::SynapseDecoder decoder)
 
 void SynapseArray::set_all_weights(::HMF::HICANN::SynapseWeight weight)
 {
+	m_generations.touch_all();
 	for (auto & row : weights)
 	{
 		std::fill(row.begin(), row.end(), weight);
 	}
 }
 
+size_t SynapseArray::packed_bytes()
+{
+	size_t const n_weights = std::tuple_size<weights_type>::value *
+	                         std::tuple_size<weight_row_type>::value;
+	size_t const n_decoders = std::tuple_size<decoders_type>::value *
+	                          std::tuple_size< ::HMF::HICANN::DecoderDoubleRow>::value *
+	                          std::tuple_size<decoder_row_type>::value;
+	return packed_size(n_weights + n_decoders, packed_bits);
+}
+
+std::vector<uint8_t> SynapseArray::pack() const
+{
+	std::vector<uint8_t> data(packed_bytes(), 0);
+	size_t index = 0;
+	for (auto const& row : weights) {
+		for (auto const& weight : row) {
+			pack_bits(data, packed_bits, index++, weight.value());
+		}
+	}
+	for (auto const& double_row : decoders) {
+		for (auto const& row : double_row) {
+			for (auto const& decoder : row) {
+				pack_bits(data, packed_bits, index++, decoder.value());
+			}
+		}
+	}
+	return data;
+}
+
+void SynapseArray::unpack(std::vector<uint8_t> const& data)
+{
+	size_t index = 0;
+	for (auto& row : weights) {
+		for (auto& weight : row) {
+			weight = ::HMF::HICANN::SynapseWeight(unpack_bits(data, packed_bits, index++));
+		}
+	}
+	for (auto& double_row : decoders) {
+		for (auto& row : double_row) {
+			for (auto& decoder : row) {
+				decoder = ::HMF::HICANN::SynapseDecoder(unpack_bits(data, packed_bits, index++));
+			}
+		}
+	}
+}
+
 std::ostream& operator<<(std::ostream& os, SynapseArray const& a)
 {
 	os << "active Synapses: " << std::endl;
@@ -1,21 +1,84 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <boost/serialization/binary_object.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/version.hpp>
+
 #include "halco/hicann/v2/fwd.h"
 #include "hal/HICANN/SynapseDriver.h"
 #include "hal/HICANNContainer.h"
 
+#include "sthal/PackedSerialization.h"
 #include "sthal/macros.h"
 
 namespace sthal {
 
+/// Mutable proxies of a SynapseArray alive per synapse row, cf. SynapseRowLease.
+/// Belongs to the storage of an array: copies start without proxies and
+/// assignments keep the proxies of the target.
+class SynapseRowLeases
+{
+public:
+	static size_t const no_rows = ::halco::hicann::v2::SynapseRowOnHICANN::size;
+
+	SynapseRowLeases();
+	SynapseRowLeases(SynapseRowLeases const&);
+	SynapseRowLeases& operator=(SynapseRowLeases const&);
+
+	void acquire(size_t row);
+	void release(size_t row);
+
+	/// whether any row is leased or has been released since #reset_released()
+	bool any() const;
+	/// whether the row is leased or has been released since #reset_released()
+	bool leased(size_t row) const;
+	void reset_released();
+
+private:
+	std::array<uint32_t, no_rows> m_count;
+	std::array<bool, no_rows> m_released;
+	size_t m_total;
+	bool m_any_released;
+};
+
+/// Lease of a synapse row held by a mutable proxy. Writes through a proxy are not
+/// visible to the array, so the row is reported as modified whenever the array is
+/// queried for modifications while the lease exists, and once more after it has
+/// been released (cf. SynapseArray::generation()). Not thread-safe.
+class SynapseRowLease
+{
+public:
+	SynapseRowLease();
+	SynapseRowLease(SynapseRowLeases& leases, size_t row);
+	SynapseRowLease(SynapseRowLease const& other);
+	SynapseRowLease& operator=(SynapseRowLease const& other);
+	~SynapseRowLease();
+
+private:
+	SynapseRowLeases* m_leases;
+	size_t m_row;
+};
+
 struct SynapseRowProxy
 {
 	SynapseRowProxy(::HMF::HICANN::DecoderRow & d, ::HMF::HICANN::WeightRow & w) :
 		decoders(d), weights(w)
 	{}
 
+	SynapseRowProxy(
+		::HMF::HICANN::DecoderRow & d, ::HMF::HICANN::WeightRow & w, SynapseRowLease const& lease) :
+		decoders(d), weights(w), m_lease(lease)
+	{}
+
 	::HMF::HICANN::DecoderRow & decoders;
 	::HMF::HICANN::WeightRow & weights;
+
+private:
+	SynapseRowLease m_lease;
 };
 
 struct SynapseRowConstProxy
@@ -35,8 +98,18 @@ struct SynapseProxy
 		decoder(d), weight(w)
 	{}
 
+	SynapseProxy(
+		::HMF::HICANN::SynapseDecoder & d,
+		::HMF::HICANN::SynapseWeight & w,
+		SynapseRowLease const& lease) :
+		decoder(d), weight(w), m_lease(lease)
+	{}
+
 	::HMF::HICANN::SynapseDecoder & decoder;
 	::HMF::HICANN::SynapseWeight & weight;
+
+private:
+	SynapseRowLease m_lease;
 };
 
 struct SynapseConstProxy
@@ -62,15 +135,27 @@ struct SynapseArray
 	static const size_t no_drivers = driver_coordinate::y_type::size; // TODO use enum_type, when correct
 	static const size_t no_lines   = row_coordinate::size;
 
-	STHAL_ARRAY_OPERATOR(driver_type, driver_coordinate,
-		return drivers[ii.line()];);
+	typedef uint64_t generation_type;
+
+	driver_type & operator[](driver_coordinate const & ii)
+	{
+		m_generations.touch_driver(ii);
+		return drivers[ii.line()];
+	}
+
+	driver_type const & operator[](driver_coordinate const & ii) const
+	{
+		return drivers[ii.line()];
+	}
 
 	SynapseRowProxy operator[](row_coordinate const & row)
 	{
+		m_generations.touch_row(row);
 		return SynapseRowProxy(
 				decoders[row.toSynapseDriverOnHICANN().toEnum()][
 					row.toRowOnSynapseDriver()],
-				weights[row]);
+				weights[row],
+				SynapseRowLease(m_leases, row.toEnum().value()));
 	}
 
 	SynapseRowConstProxy operator[](row_coordinate const & row) const
@@ -84,10 +169,12 @@ struct SynapseArray
 	SynapseProxy operator[](synapse_coordinate const & s)
 	{
 		const row_coordinate & row = s.toSynapseRowOnHICANN();
+		m_generations.touch_row(row);
 		return SynapseProxy(
 				decoders[row.toSynapseDriverOnHICANN().toEnum()][
 					row.toRowOnSynapseDriver()][s.toSynapseColumnOnHICANN()],
-				weights[row][s.toSynapseColumnOnHICANN()]);
+				weights[row][s.toSynapseColumnOnHICANN()],
+				SynapseRowLease(m_leases, row.toEnum().value()));
 	}
 
 	SynapseConstProxy operator[](synapse_coordinate const & s) const
@@ -108,6 +195,7 @@ struct SynapseArray
 	void setDecoderDoubleRow(driver_coordinate const & s,
 			const ::HMF::HICANN::DecoderDoubleRow & row)
 	{
+		m_generations.touch_decoder(s);
 		decoders[s.line()] = row;
 	}
 
@@ -121,6 +209,30 @@ struct SynapseArray
 	/// returns full address based on decoder settings from driver and synapse
 	::HMF::HICANN::L1Address get_address(halco::hicann::v2::SynapseOnHICANN const& s) const;
 
+	/// Modification tracking: every mutable access to a driver, decoder double row or
+	/// weight row (operator[], proxies, setDecoderDoubleRow, clear_* and set_all_*)
+	/// stamps it with the next generation of this array. Copies and deserialized arrays
+	/// start a new history, i.e. generations are only comparable within one history.
+	/// Rows of mutable proxies still alive are stamped again by every query
+	/// (generation(), changed_*(), content_hash()) and once more after the proxy is
+	/// gone, so writes through long-lived proxies are noticed.
+	/// Note: references to drivers and references into rows taken from a proxy
+	/// are not tracked beyond the lifetime of the access or proxy. Driver changes are
+	/// still detected by content_hash() and the smart configurator, which compare the
+	/// drivers in full.
+	uint64_t history() const;
+	generation_type generation() const;
+
+	/// drivers / decoder double rows / weight rows accessed mutably after generation since
+	std::vector<driver_coordinate> changed_drivers(generation_type since) const;
+	std::vector<driver_coordinate> changed_decoders(generation_type since) const;
+	std::vector<row_coordinate> changed_weights(generation_type since) const;
+
+	/// 64 bit hash of the content (drivers, decoders and weights), cf. content_hash().
+	/// It is maintained incrementally: only drivers with modified rows since the last
+	/// call are rehashed. Not thread-safe.
+	uint64_t content_hash() const;
+
 	friend bool operator==(const SynapseArray & a, const SynapseArray & b);
 	friend bool operator!=(const SynapseArray & a, const SynapseArray & b);
 	friend std::ostream& operator<<(std::ostream& os, SynapseArray const& a);
@@ -134,16 +246,84 @@ private:
 	weights_type  weights;
 	decoders_type decoders;
 
+	/// generations of the last mutable access, not part of the configuration
+	class Generations
+	{
+	public:
+		Generations();
+		// copies start a new history
+		Generations(Generations const&);
+		Generations& operator=(Generations const&);
+
+		void renew();
+		void touch_driver(driver_coordinate const& driver);
+		void touch_decoder(driver_coordinate const& driver);
+		void touch_row(row_coordinate const& row);
+		void touch_all();
+
+		uint64_t history;
+		generation_type current;
+		std::array<generation_type, no_drivers> drivers;
+		std::array<generation_type, no_drivers> decoders;
+		std::array<generation_type, no_lines> weights;
+
+		// content hash cache, valid for all entries not modified after generation hashed;
+		// drivers are compared to the hashed ones, references to them are not tracked
+		bool hash_valid;
+		generation_type hashed;
+		uint64_t hash;
+		std::array<uint64_t, no_drivers> driver_hashes;
+		std::array<driver_type, no_drivers> hashed_drivers;
+	};
+
+	uint64_t driver_hash(driver_coordinate const& driver) const;
+
+	/// stamps the rows of mutable proxies alive or released since the last call
+	void stamp_leased_rows() const;
+
+	/// weights and decoders packed as 4 bit values, cf. serialize()
+	static size_t const packed_bits = 4;
+	static size_t packed_bytes();
+	std::vector<uint8_t> pack() const;
+	void unpack(std::vector<uint8_t> const& data);
+
+	mutable Generations m_generations;
+	mutable SynapseRowLeases m_leases;
+
 	friend class boost::serialization::access;
 	template<typename Archiver>
-	void serialize(Archiver& ar, unsigned int const)
+	void serialize(Archiver& ar, unsigned int const version)
 	{
-		ar & boost::serialization::make_nvp("drivers",  drivers)
-		   & boost::serialization::make_nvp("weights",  weights)
-		   & boost::serialization::make_nvp("decoders", decoders);
+		using boost::serialization::make_nvp;
+		ar & make_nvp("drivers",  drivers);
+		if (version >= 1 && is_packed_archive<Archiver>::value) {
+			// binary archives store weights and decoders as one packed block
+			std::vector<uint8_t> data;
+			if (!Archiver::is_loading::value) {
+				data = pack();
+			} else {
+				data.resize(packed_bytes());
+			}
+			auto binary = boost::serialization::make_binary_object(data.data(), data.size());
+			ar & make_nvp("packed", binary);
+			if (Archiver::is_loading::value) {
+				unpack(data);
+			}
+		} else {
+			ar & make_nvp("weights",  weights)
+			   & make_nvp("decoders", decoders);
+		}
+		if (Archiver::is_loading::value) {
+			m_generations.renew();
+		}
 	}
 };
 
+/// content hash of the synapse array, maintained incrementally
+uint64_t content_hash(SynapseArray const& synapses);
+
 } // end namespace sthal
 
+BOOST_CLASS_VERSION(sthal::SynapseArray, 1)
+
 #include "sthal/macros_undef.h"
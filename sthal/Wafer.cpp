@@ -1,13 +1,32 @@
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <exception>
+#include <functional>
+#include <map>
+#include <numeric>
+#include <sstream>
 #include <thread>
 
 #include <boost/algorithm/string.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
+#include <boost/iostreams/filter/bzip2.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/version.hpp>
+#if BOOST_VERSION >= 107900
+#define STHAL_HAVE_ZSTD
+#include <boost/iostreams/filter/zstd.hpp>
+#endif
+#include <boost/make_shared.hpp>
 #include <boost/scope_exit.hpp>
 
 #include <boost/serialization/nvp.hpp>
 #include <boost/serialization/shared_ptr.hpp>
+#include <boost/serialization/vector.hpp>
 #include "boost/serialization/array.h"
 
 #include "boost/serialization/serialization_helper.tcc"
@@ -17,11 +36,15 @@ extern "C" {
 }
 
 #include "sthal/AnalogRecorder.h"
+#include "sthal/ChunkedArchive.h"
+#include "sthal/ConfigurationScheduler.h"
 #include "sthal/ConfigurationStages.h"
 #include "sthal/Defects.h"
 #include "sthal/ExperimentRunner.h"
 #include "sthal/FPGA.h"
+#include "sthal/FPGABringUp.h"
 #include "sthal/HICANNConfigurator.h"
+#include "sthal/HICANNDataDelta.h"
 #include "sthal/HICANNv4Configurator.h"
 #include "sthal/HardwareDatabase.h"
 #include "sthal/ParallelHICANNv4SmartConfigurator.h"
@@ -124,7 +147,7 @@ std::vector<Wafer::hicann_coord> Wafer::getAllocatedHicannCoordinates() const
 	std::vector<Wafer::hicann_coord> ret;
 	std::copy_if(iter_all<HICANNOnWafer>().begin(), iter_all<HICANNOnWafer>().end(),
 	             std::back_inserter(ret),
-	             [this](HICANNOnWafer const coord) { return mHICANN[coord]; });
+	             [this](HICANNOnWafer const coord) { return mHICANN[coord] || is_lazy(coord); });
 	return ret;
 }
 
@@ -210,6 +233,7 @@ namespace {
 
 void Wafer::populate_adc_config(hicann_coord const& hicann, analog_coord const& analog)
 {
+	load_lazy_hicann(hicann);
 	auto h = mHICANN[hicann];
 
 	if(!mHardwareDatabase) {
@@ -234,6 +258,9 @@ void Wafer::populate_adc_config(hicann_coord const& hicann, analog_coord const&
 
 void Wafer::connect(const HardwareDatabase & db)
 {
+	load_lazy_hicanns();
+	mLazyChunks.reset();
+
 	mHardwareDatabase = db.clone();
 
 	const size_t num_fpgas = std::count_if(
@@ -318,6 +345,8 @@ void Wafer::connect(const HardwareDatabase & db)
 	}
 	mConnected = true;
 	LOG4CXX_INFO(plogger, "Connected to hardware");
+
+	load_smart_configurator_state();
 }
 
 void Wafer::configure() {
@@ -325,6 +354,89 @@ void Wafer::configure() {
 	configure(default_configurator);
 }
 
+void Wafer::configure_fpgas(HICANNConfigurator & configurator)
+{
+	auto t = Timer::from_literal_string(__PRETTY_FUNCTION__);
+
+	// compact list of allocated FPGAs, including the master FPGA without HICANNs
+	std::vector<std::pair<fpga_t, fpga_handle_t> > fpgas;
+	for (auto fpga_c : iter_all<FPGAOnWafer>()) {
+		fpga_t fpga = mFPGA.at(fpga_c);
+		if (!fpga) {
+			continue;
+		}
+		check_fpga_handle(mFPGAHandle.at(fpga_c), fpga);
+		fpgas.emplace_back(fpga, mFPGAHandle.at(fpga_c));
+	}
+
+	FPGABringUp bring_up;
+	bring_up.is_master = [&fpgas](size_t ii) { return fpgas[ii].second->isMaster(); };
+	bring_up.config = [&configurator, &fpgas](size_t ii) {
+		// master FPGA that is not used in experiment besides global systart
+		if (!fpgas[ii].first->getAllocatedHICANNs().empty()) {
+			configurator.config_fpga(fpgas[ii].second, fpgas[ii].first);
+		}
+	};
+	bring_up.disable_global = [&configurator, &fpgas](size_t ii) {
+		configurator.disable_global(fpgas[ii].second);
+	};
+	bring_up.prime_systime_counter = [&configurator, &fpgas](size_t ii) {
+		configurator.prime_systime_counter(fpgas[ii].second);
+	};
+	bring_up.start_systime_counter = [&configurator, &fpgas](size_t ii) {
+		configurator.start_systime_counter(fpgas[ii].second);
+	};
+	auto const phase_ms = bring_up.run(fpgas.size());
+
+	std::stringstream phases;
+	for (size_t phase = 0; phase < FPGABringUp::PHASES; ++phase) {
+		phases << ", " << FPGABringUp::phase_name(static_cast<FPGABringUp::Phase>(phase)) << ": "
+		       << phase_ms[phase] << "ms";
+	}
+	LOG4CXX_DEBUG(
+	    getTimeLogger(), short_format(index()) << ": FPGA bring-up of " << fpgas.size()
+	                                           << " FPGA(s) took " << t.get_ms() << "ms"
+	                                           << phases.str());
+}
+
+std::vector<size_t> Wafer::l1_groups(std::vector<FPGAOnWafer> const& fpgas) const
+{
+	// union-find over FPGAs, joined if allocated HICANNs are L1 neighbours
+	std::vector<size_t> parent(fpgas.size());
+	std::iota(parent.begin(), parent.end(), 0);
+	std::function<size_t(size_t)> const find = [&parent, &find](size_t ii) {
+		return parent[ii] == ii ? ii : (parent[ii] = find(parent[ii]));
+	};
+
+	std::map<HICANNOnWafer, size_t> hicann_to_fpga;
+	for (size_t ii = 0; ii < fpgas.size(); ++ii) {
+		for (auto hicann_c : mFPGA.at(fpgas[ii])->getAllocatedHICANNs()) {
+			hicann_to_fpga[hicann_c] = ii;
+		}
+	}
+
+	for (auto const& item : hicann_to_fpga) {
+		HICANNOnWafer const& hicann_c = item.first;
+		for (auto const& offset : {std::make_pair(1, 0), std::make_pair(0, 1)}) {
+			try {
+				auto const it = hicann_to_fpga.find(HICANNOnWafer(
+				    X(hicann_c.x() + offset.first), Y(hicann_c.y() + offset.second)));
+				if (it != hicann_to_fpga.end()) {
+					parent[find(item.second)] = find(it->second);
+				}
+			} catch (std::exception const&) {
+				// no HICANN at this position
+			}
+		}
+	}
+
+	std::vector<size_t> groups(fpgas.size());
+	for (size_t ii = 0; ii < fpgas.size(); ++ii) {
+		groups[ii] = find(ii);
+	}
+	return groups;
+}
+
 void Wafer::configure(HICANNConfigurator & configurator)
 {
 	auto t = Timer::from_literal_string(__PRETTY_FUNCTION__);
@@ -346,106 +458,36 @@ void Wafer::configure(HICANNConfigurator & configurator)
 	auto* const v4_configurator = dynamic_cast<HICANNv4Configurator*>(&configurator);
 	bool const is_v4_cfg = (v4_configurator != nullptr);
 
-	// check for global changes configuration changes
-	configure_l1_bus_locking(configurator);
-
-	/// First reset / configure FPGAs
-	#pragma omp parallel for schedule(dynamic)
-	for (size_t fpga_enum = 0; fpga_enum < FPGAOnWafer::end; ++fpga_enum) {
-		FPGAOnWafer const fpga_c{Enum(fpga_enum)};
-		fpga_t fpga = mFPGA.at(fpga_c);
-		fpga_handle_t fpga_handle = mFPGAHandle.at(fpga_c);
-		// Skip if FPGA is not allocated or FPGA has no allocated HICANNs,
-		// i.e. master FPGA that is not used in experiment besides global systart
-		if (!fpga || fpga->getAllocatedHICANNs().empty()) {
-			continue;
-		}
-		check_fpga_handle(fpga_handle, fpga);
-		configurator.config_fpga(fpga_handle, fpga);
-	}
-
-	#pragma omp parallel for schedule(dynamic)
-	for (size_t fpga_enum = 0; fpga_enum < FPGAOnWafer::end; ++fpga_enum) {
-		FPGAOnWafer const fpga_c{Enum(fpga_enum)};
-		fpga_t fpga = mFPGA.at(fpga_c);
-		fpga_handle_t fpga_handle = mFPGAHandle.at(fpga_c);
-		if (!fpga) {
-			continue;
-		}
-		check_fpga_handle(fpga_handle, fpga);
-		configurator.disable_global(fpga_handle);
-	}
-
-	/// prime systime counters on all fpgas
-	#pragma omp parallel for schedule(dynamic)
-	for (size_t fpga_enum = 0; fpga_enum < FPGAOnWafer::end; ++fpga_enum) {
-		FPGAOnWafer const fpga_c{Enum(fpga_enum)};
-		fpga_t fpga = mFPGA.at(fpga_c);
-		fpga_handle_t fpga_handle = mFPGAHandle.at(fpga_c);
-		// Skip if FPGA is not allocated, do as well for master FPGA
-		if (!fpga) {
-			continue;
-		}
-		check_fpga_handle(fpga_handle, fpga);
-		configurator.prime_systime_counter(fpga_handle);
-	}
-
-	/// start systime counters on all fpgas
-	#pragma omp parallel for schedule(dynamic)
-	for (size_t fpga_enum = 0; fpga_enum < FPGAOnWafer::end; ++fpga_enum) {
-		FPGAOnWafer const fpga_c{Enum(fpga_enum)};
-		fpga_t fpga = mFPGA.at(fpga_c);
-		fpga_handle_t fpga_handle = mFPGAHandle.at(fpga_c);
-		if (!fpga) {
-			continue;
+	auto* const smart_configurator =
+	    dynamic_cast<ParallelHICANNv4SmartConfigurator*>(&configurator);
+	if (mStateStore) {
+		if (smart_configurator && mStoredSmartState && !smart_configurator->has_state()) {
+			smart_configurator->adopt_state(*mStoredSmartState);
 		}
-		check_fpga_handle(fpga_handle, fpga);
-		configurator.start_systime_counter(fpga_handle);
+		mStoredSmartState.reset();
+		// the hardware state is unknown until this configuration succeeded
+		mStateStore->invalidate();
 	}
 
-	// for all but master
-	#pragma omp parallel for schedule(dynamic)
-	for (size_t fpga_enum = 0; fpga_enum < FPGAOnWafer::end; ++fpga_enum) {
-		FPGAOnWafer const fpga_c{Enum(fpga_enum)};
-		fpga_t fpga = mFPGA.at(fpga_c);
-		fpga_handle_t fpga_handle = mFPGAHandle.at(fpga_c);
-		if (!fpga || fpga_handle->isMaster()) {
-			continue;
-		}
-		check_fpga_handle(fpga_handle, fpga);
-		configurator.disable_global(fpga_handle);
-	}
+	// check for global changes configuration changes
+	configure_l1_bus_locking(configurator);
 
-	// for master
-	#pragma omp parallel for schedule(dynamic)
-	for (size_t fpga_enum = 0; fpga_enum < FPGAOnWafer::end; ++fpga_enum) {
-		FPGAOnWafer const fpga_c{Enum(fpga_enum)};
-		fpga_t fpga = mFPGA.at(fpga_c);
-		fpga_handle_t fpga_handle = mFPGAHandle.at(fpga_c);
-		if (!fpga || !fpga_handle->isMaster()) {
-			continue;
-		}
-		check_fpga_handle(fpga_handle, fpga);
-		configurator.disable_global(fpga_handle);
-	}
+	configure_fpgas(configurator);
 
 	// systime counters are started on all allocated FPGAs, which is noted for the
 	// smart configurator
 	note_systime_start(configurator);
 
-	std::map<ConfigurationStage, size_t> const serial_stage_sleep = {
-	    {ConfigurationStage::TIMING_UNCRITICAL, 0}};
-	const std::vector<ConfigurationStage> serial_stages = {
-	    ConfigurationStage::TIMING_UNCRITICAL};
-
 	auto const& settings = Settings::get();
-	auto const& parallel_stage_sleep = settings.configuration_stages.sleeps;
-	auto const& parallel_stages = settings.configuration_stages.order;
 
-	auto const call_stages =
-	    (is_hicann_parallel) ? parallel_stages : serial_stages;
-	auto const sleep_stages =
-	    (is_hicann_parallel) ? parallel_stage_sleep : serial_stage_sleep;
+	// configurators not derived from ParallelHICANNv4Configurator do not know about stages
+	Settings::CfgStages serial_stages;
+	serial_stages.order = {ConfigurationStage::TIMING_UNCRITICAL};
+	serial_stages.sleeps = {{ConfigurationStage::TIMING_UNCRITICAL, 0}};
+	serial_stages.l1_dependencies.clear();
+
+	auto const& call_stages =
+	    (is_hicann_parallel) ? settings.configuration_stages : serial_stages;
 
 	/// Check for invalid/dangerous HICANN configuration
 	for (size_t fpga_enum = 0; fpga_enum < FPGAOnWafer::end; ++fpga_enum) {
@@ -493,70 +535,70 @@ void Wafer::configure(HICANNConfigurator & configurator)
 	}
 
 	/// Then configure HICANNs
-	for (auto stage : call_stages) {
-		/// Comment the following #pragma line while debugging, in order to get
-		/// meaningful error messages.
-		#pragma omp parallel for schedule(dynamic)
-		for (size_t fpga_enum = 0; fpga_enum < FPGAOnWafer::end; ++fpga_enum) {
-			FPGAOnWafer const fpga_c{Enum(fpga_enum)};
-			fpga_t fpga = mFPGA.at(fpga_c);
-			fpga_handle_t fpga_handle = mFPGAHandle.at(fpga_c);
-			if (!fpga || fpga->getAllocatedHICANNs().empty()) {
-				continue;
-			}
-			check_fpga_handle(fpga_handle, fpga);
-			std::vector<HICANNOnWafer> hicann_coords;
-			ParallelHICANNv4Configurator::hicann_handles_t hicann_handles;
-			ParallelHICANNv4Configurator::hicann_datas_t hicann_datas;
-			for (HICANNOnWafer hicann_c : fpga->getAllocatedHICANNs()) {
-				if (auto hicann = mHICANN.at(hicann_c)) {
-					hicann_coords.push_back(hicann_c);
-					hicann_handles.push_back(fpga_handle->get(hicann_c));
-					hicann_datas.push_back(hicann);
-				}
-			}
+	std::vector<FPGAOnWafer> fpgas;
+	for (auto fpga_c : iter_all<FPGAOnWafer>()) {
+		fpga_t fpga = mFPGA.at(fpga_c);
+		if (!fpga || fpga->getAllocatedHICANNs().empty()) {
+			continue;
+		}
+		check_fpga_handle(mFPGAHandle.at(fpga_c), fpga);
+		fpgas.push_back(fpga_c);
+	}
 
-			if (is_hicann_parallel && !is_v4_cfg) {
-				parallel_configurator->config(fpga_handle, hicann_handles, hicann_datas,
-				                              stage);
-			} else if (is_v4_cfg) {
-				// The HICANNv4Configurator is a wrapper of the ParallelHICANNv4Configurator
-				// which offers the same functionality as its base class but performs
-				// HICANN configuration sequentially, i.e. configure one HICANN at a time
-				// (c.f. header of HICANNv4Configurator): That different behavior is achieved
-				// here, since the configuration calls will be either parallel or sequential
-				// depending on the configurator provided to this Wafer::configure function.
-				// We don't use ParallelHICANNConfigurator::config(fpga_handle_t f,
-				// hicann_handle_t h, hicann_data_t hd) since that function doesn't sleep
-				// after every configuration stage.
-				assert(hicann_handles.size() == hicann_datas.size());
-				for (auto item : pythonic::zip(hicann_handles, hicann_datas)) {
-					v4_configurator->config(
-						fpga_handle,
-						ParallelHICANNv4Configurator::hicann_handles_t{std::get<0>(item)},
-						ParallelHICANNv4Configurator::hicann_datas_t{std::get<1>(item)},
-						stage);
-				}
-			} else {
-				// Any other configurator that does not inherit from ParallelHICANNv4Configurator
-				assert(hicann_handles.size() == hicann_datas.size());
-				for (auto item : pythonic::zip(hicann_handles, hicann_datas)) {
-					configurator.config(fpga_handle, std::get<0>(item),
-					                    std::get<1>(item));
-				}
+	ConfigurationScheduler scheduler(call_stages, l1_groups(fpgas));
+	/// To get meaningful error messages while debugging, set OMP_NUM_THREADS=1.
+	scheduler.run([&](size_t const ii, ConfigurationStage const stage) {
+		fpga_t fpga = mFPGA.at(fpgas[ii]);
+		fpga_handle_t fpga_handle = mFPGAHandle.at(fpgas[ii]);
+
+		std::vector<HICANNOnWafer> hicann_coords;
+		ParallelHICANNv4Configurator::hicann_handles_t hicann_handles;
+		ParallelHICANNv4Configurator::hicann_datas_t hicann_datas;
+		for (HICANNOnWafer hicann_c : fpga->getAllocatedHICANNs()) {
+			if (auto hicann = mHICANN.at(hicann_c)) {
+				hicann_coords.push_back(hicann_c);
+				hicann_handles.push_back(fpga_handle->get(hicann_c));
+				hicann_datas.push_back(hicann);
 			}
+		}
 
-			// sync command buffers
-			configurator.sync_command_buffers(fpga_handle, hicann_handles);
-		} // fpgas
-		if (sleep_stages.at(stage)) {
-			auto const sleep_interval = std::chrono::milliseconds(sleep_stages.at(stage));
-			LOG4CXX_DEBUG(
-			    logger, "sleeping for " << sleep_interval.count() << " ms after stage "
-			                            << static_cast<size_t>(stage));
-			std::this_thread::sleep_for(sleep_interval);
+		if (is_hicann_parallel && !is_v4_cfg) {
+			parallel_configurator->config(fpga_handle, hicann_handles, hicann_datas,
+			                              stage);
+		} else if (is_v4_cfg) {
+			// The HICANNv4Configurator is a wrapper of the ParallelHICANNv4Configurator
+			// which offers the same functionality as its base class but performs
+			// HICANN configuration sequentially, i.e. configure one HICANN at a time
+			// (c.f. header of HICANNv4Configurator): That different behavior is achieved
+			// here, since the configuration calls will be either parallel or sequential
+			// depending on the configurator provided to this Wafer::configure function.
+			// We don't use ParallelHICANNConfigurator::config(fpga_handle_t f,
+			// hicann_handle_t h, hicann_data_t hd) since that function doesn't sleep
+			// after every configuration stage.
+			assert(hicann_handles.size() == hicann_datas.size());
+			for (auto item : pythonic::zip(hicann_handles, hicann_datas)) {
+				v4_configurator->config(
+					fpga_handle,
+					ParallelHICANNv4Configurator::hicann_handles_t{std::get<0>(item)},
+					ParallelHICANNv4Configurator::hicann_datas_t{std::get<1>(item)},
+					stage);
+			}
+		} else {
+			// Any other configurator that does not inherit from ParallelHICANNv4Configurator
+			assert(hicann_handles.size() == hicann_datas.size());
+			for (auto item : pythonic::zip(hicann_handles, hicann_datas)) {
+				configurator.config(fpga_handle, std::get<0>(item),
+				                    std::get<1>(item));
+			}
 		}
-	} // stages
+
+		// sync command buffers
+		configurator.sync_command_buffers(fpga_handle, hicann_handles);
+	});
+
+	if (mStateStore && smart_configurator) {
+		mStateStore->save(mStateKey, *smart_configurator);
+	}
 
 	LOG4CXX_DEBUG(getTimeLogger(), short_format(index())
 		      << ": configure took " << t.get_ms()
@@ -577,6 +619,12 @@ void Wafer::restart(ExperimentRunner & runner)
 	runner.run(mFPGA, mFPGAHandle);
 }
 
+batch_pulse_events Wafer::run_batch(ExperimentRunner & runner, batch_pulse_events const& stimuli)
+{
+	LOG4CXX_DEBUG(plogger, "Run batch of " << stimuli.size() << " experiment(s)");
+	return runner.run_batch(mFPGA, mFPGAHandle, stimuli);
+}
+
 
 void Wafer::disconnect()
 {
@@ -597,6 +645,8 @@ void Wafer::disconnect()
             h->resetADCConfig();
 		}
 	}
+	mStateStore.reset();
+	mStoredSmartState.reset();
 	mConnected = false;
 	LOG4CXX_INFO(plogger, "Disconnected from hardware");
 }
@@ -604,6 +654,7 @@ void Wafer::disconnect()
 
 HICANN & Wafer::operator[](const hicann_coord & hicann)
 {
+	load_lazy_hicann(hicann);
 
 	auto& ret = mHICANN.at(hicann);
 	if (!ret)
@@ -620,6 +671,8 @@ HICANN & Wafer::operator[](const hicann_coord & hicann)
 
 const HICANN & Wafer::operator[](const hicann_coord & hicann) const
 {
+	load_lazy_hicann(hicann);
+
 	auto const& ret = mHICANN.at(hicann);
 	if (!ret)
 	{
@@ -631,6 +684,8 @@ const HICANN & Wafer::operator[](const hicann_coord & hicann) const
 FPGA &
 Wafer::operator[](const fpga_coord & fc)
 {
+	load_lazy_hicanns(fc);
+
 	auto & fpga = mFPGA[fc];
 	if (!fpga)
 	{
@@ -660,6 +715,8 @@ Wafer::operator[](const fpga_coord & fc)
 const FPGA &
 Wafer::operator[](const fpga_coord & fc) const
 {
+	load_lazy_hicanns(fc);
+
 	auto & fpga = mFPGA[fc];
 	if (!fpga)
 	{
@@ -699,13 +756,8 @@ Status Wafer::status() const
 	st.adc_channels = this->mADCChannels;
 
 	st.wafer = mWafer;
-	for (auto hicann : mHICANN)
-	{
-		if(hicann)
-		{
-			st.hicanns.push_back(hicann->index());
-		}
-	}
+	// includes HICANNs not loaded yet by open_lazy()
+	st.hicanns = getAllocatedHicannCoordinates();
 
 	st.git_rev_halbe = ::HMF::Debug::getHalbeGitVersion();
 	st.git_rev_hicann_system = ::HMF::Debug::getHicannSystemGitVersion();
@@ -726,6 +778,9 @@ Status Wafer::status() const
 			st.fpga_id[ii] = st.fpga_rev[ii] = 0;
 			st.fpga_drops[ii] = {};
 		}
+		if (auto const& fpga = mFPGA[ii]) {
+			st.received_spikes[ii] = fpga->getReceivedSpikeStatistics();
+		}
 	}
 	return st;
 }
@@ -752,6 +807,100 @@ void Wafer::clearSpikes(bool received, bool send)
 	}
 }
 
+namespace {
+
+enum class Compression
+{
+	None,
+	Gzip,
+	Bzip2,
+	Zstd
+};
+
+/// Compression selected by the last extension of a dump, e.g. "wafer.xml.gz"
+Compression compression(boost::filesystem::path const& filename)
+{
+	auto const extension = filename.extension();
+	if (extension == ".gz") {
+		return Compression::Gzip;
+	} else if (extension == ".bz2") {
+		return Compression::Bzip2;
+	} else if (extension == ".zst") {
+#ifdef STHAL_HAVE_ZSTD
+		return Compression::Zstd;
+#else
+		throw std::runtime_error(
+			"zstd compressed dumps need boost::iostreams >= 1.79: " + filename.string());
+#endif
+	}
+	return Compression::None;
+}
+
+/// Extension selecting the archive type, i.e. without the compression extension
+boost::filesystem::path archive_extension(boost::filesystem::path const& filename)
+{
+	if (compression(filename) == Compression::None) {
+		return filename.extension();
+	}
+	return filename.stem().extension();
+}
+
+char const* compression_name(Compression const codec)
+{
+	switch (codec) {
+		case Compression::Gzip:
+			return ", gzip";
+		case Compression::Bzip2:
+			return ", bzip2";
+		case Compression::Zstd:
+			return ", zstd";
+		default:
+			return "";
+	}
+}
+
+void push_compressor(boost::iostreams::filtering_ostream& stream, Compression const codec)
+{
+	namespace io = boost::iostreams;
+	switch (codec) {
+		case Compression::Gzip:
+			stream.push(io::gzip_compressor());
+			break;
+		case Compression::Bzip2:
+			stream.push(io::bzip2_compressor());
+			break;
+#ifdef STHAL_HAVE_ZSTD
+		case Compression::Zstd:
+			stream.push(io::zstd_compressor());
+			break;
+#endif
+		default:
+			break;
+	}
+}
+
+void push_decompressor(boost::iostreams::filtering_istream& stream, Compression const codec)
+{
+	namespace io = boost::iostreams;
+	switch (codec) {
+		case Compression::Gzip:
+			stream.push(io::gzip_decompressor());
+			break;
+		case Compression::Bzip2:
+			stream.push(io::bzip2_decompressor());
+			break;
+#ifdef STHAL_HAVE_ZSTD
+		case Compression::Zstd:
+			stream.push(io::zstd_decompressor());
+			break;
+#endif
+		default:
+			break;
+	}
+}
+
+} // anonymous namespace
+
 void Wafer::dump(const char * const _filename, bool overwrite) const
 {
 	boost::filesystem::path filename(_filename);
@@ -762,14 +911,34 @@ void Wafer::dump(const char * const _filename, bool overwrite) const
 		err += "' allready exists!";
 		throw std::runtime_error(err);
 	}
-	boost::filesystem::ofstream stream(filename);
-	if (filename.extension() == ".xml") {
-		LOG4CXX_INFO(logger, "Wafer config (xml) dump to: " << filename);
+	load_lazy_hicanns();
+	Compression const codec = compression(filename);
+	auto const extension = archive_extension(filename);
+	if (extension == ".chunked") {
+		if (codec != Compression::None) {
+			throw std::invalid_argument(
+				"chunked dumps cannot be compressed: " + filename.string());
+		}
+		LOG4CXX_INFO(logger, "Wafer config (chunked) dump to: " << filename);
+		dump_chunked(filename.string());
+		return;
+	}
+	boost::filesystem::ofstream file(filename, std::ios::binary);
+	boost::iostreams::filtering_ostream stream;
+	push_compressor(stream, codec);
+	stream.push(file);
+	if (extension == ".xml") {
+		LOG4CXX_INFO(logger, "Wafer config (xml" << compression_name(codec) << ") dump to: " << filename);
 		boost::archive::xml_oarchive{stream} << boost::serialization::make_nvp("wafer", *this);
 	} else {
-		LOG4CXX_INFO(logger, "Wafer config (binary) dump to: " << filename);
+		LOG4CXX_INFO(logger, "Wafer config (binary" << compression_name(codec) << ") dump to: " << filename);
 		boost::archive::binary_oarchive{stream} << *this;
 	}
+	// flushes the compressor
+	stream.reset();
+	if (!file) {
+		throw std::runtime_error("writing '" + filename.string() + "' failed");
+	}
 }
 
 void Wafer::save(const char* const _filename, bool overwrite) const
@@ -787,17 +956,499 @@ void Wafer::load(const char * const _filename)
 		err += "' not found!";
 		throw std::runtime_error(err);
 	}
-	boost::filesystem::ifstream stream(filename);
 	disconnect();
-	if (filename.extension() == ".xml") {
-		LOG4CXX_INFO(logger, "Wafer config (xml) load from: " << filename);
+	mLazyChunks.reset();
+	if (ChunkedArchive::is_chunked_archive(filename.string())) {
+		LOG4CXX_INFO(logger, "Wafer config (chunked) load from: " << filename);
+		load_chunked(filename.string());
+		return;
+	}
+	Compression const codec = compression(filename);
+	boost::filesystem::ifstream file(filename, std::ios::binary);
+	boost::iostreams::filtering_istream stream;
+	push_decompressor(stream, codec);
+	stream.push(file);
+	if (archive_extension(filename) == ".xml") {
+		LOG4CXX_INFO(logger, "Wafer config (xml" << compression_name(codec) << ") load from: " << filename);
 		boost::archive::xml_iarchive{stream} >> boost::serialization::make_nvp("wafer", *this);
 	} else {
-		LOG4CXX_INFO(logger, "Wafer config (binary) load from: " << filename);
+		LOG4CXX_INFO(logger, "Wafer config (binary" << compression_name(codec) << ") load from: " << filename);
 		boost::archive::binary_iarchive{stream} >> *this;
 	}
 }
 
+namespace {
+
+enum ChunkType : uint32_t
+{
+	WaferChunk,
+	FPGAChunk,
+	HICANNChunk,
+	// only in deltas, cf. Wafer::dump_delta
+	DeltaChunk,
+	HICANNDeltaChunk
+};
+
+/// Runs work(ii) for ii in [0, n) in parallel and rethrows the first exception
+void parallel_for(size_t const n, std::function<void(size_t)> const& work)
+{
+	std::exception_ptr error;
+	#pragma omp parallel for schedule(dynamic)
+	for (size_t ii = 0; ii < n; ++ii) {
+		try {
+			work(ii);
+		} catch (...) {
+			#pragma omp critical(sthal_wafer_chunks)
+			if (!error) {
+				error = std::current_exception();
+			}
+		}
+	}
+	if (error) {
+		std::rethrow_exception(error);
+	}
+}
+
+} // anonymous namespace
+
+void Wafer::dump_chunked(std::string const& filename) const
+{
+	auto t = Timer::from_literal_string(__PRETTY_FUNCTION__);
+
+	ChunkedArchive::chunks_type chunks;
+	chunks.push_back({{WaferChunk, 0}, std::string()});
+	for (auto fpga_c : iter_all<FPGAOnWafer>()) {
+		if (mFPGA[fpga_c]) {
+			chunks.push_back({{FPGAChunk, uint32_t(fpga_c.toEnum().value())}, std::string()});
+		}
+	}
+	for (auto hicann_c : iter_all<HICANNOnWafer>()) {
+		if (mHICANN[hicann_c]) {
+			chunks.push_back({{HICANNChunk, uint32_t(hicann_c.toEnum().value())}, std::string()});
+		}
+	}
+
+	parallel_for(chunks.size(), [this, &chunks](size_t const ii) {
+		auto& chunk = chunks[ii];
+		std::ostringstream stream;
+		{
+			boost::archive::binary_oarchive ar(stream);
+			switch (chunk.first.type) {
+				case WaferChunk:
+					ar << mWafer << mADCChannels << mNumHICANNs << mSharedSettings << mDefects;
+					break;
+				case FPGAChunk:
+					mFPGA[FPGAOnWafer(Enum(chunk.first.id))]->serialize_detached(ar);
+					break;
+				case HICANNChunk:
+					mHICANN[HICANNOnWafer(Enum(chunk.first.id))]->serialize_detached(ar);
+					break;
+			}
+		}
+		chunk.second = stream.str();
+	});
+
+	ChunkedArchive::write(filename, chunks);
+	LOG4CXX_DEBUG(
+		getTimeLogger(), "chunked dump of " << chunks.size() << " chunks took " << t.get_ms()
+		                                    << "ms");
+}
+
+void Wafer::load_chunked(std::string const& filename, bool const lazy)
+{
+	auto t = Timer::from_literal_string(__PRETTY_FUNCTION__);
+
+	ChunkedArchive const archive(filename);
+	if (archive.has({DeltaChunk, 0})) {
+		throw std::runtime_error(
+			"'" + filename + "' is a wafer config delta, load it together with its base");
+	}
+	{
+		std::istringstream stream(archive.read({WaferChunk, 0}));
+		boost::archive::binary_iarchive ar(stream);
+		ar >> mWafer >> mADCChannels >> mNumHICANNs >> mSharedSettings >> mDefects;
+	}
+
+	for (auto& fpga : mFPGA) {
+		fpga.reset();
+	}
+	for (auto& hicann : mHICANN) {
+		hicann.reset();
+	}
+
+	std::vector<ChunkedArchive::Key> keys = archive.keys();
+	parallel_for(keys.size(), [this, &archive, &keys, lazy](size_t const ii) {
+		auto const& key = keys[ii];
+		if (key.type != FPGAChunk && (key.type != HICANNChunk || lazy)) {
+			return;
+		}
+		std::istringstream stream(archive.read(key));
+		boost::archive::binary_iarchive ar(stream);
+		// each chunk is written by a single thread, the arrays are not resized
+		if (key.type == FPGAChunk) {
+			auto fpga = boost::make_shared<FPGA>();
+			fpga->serialize_detached(ar);
+			mFPGA[FPGAOnWafer(Enum(key.id))] = fpga;
+		} else {
+			auto hicann = boost::make_shared<HICANN>();
+			hicann->serialize_detached(ar);
+			mHICANN[HICANNOnWafer(Enum(key.id))] = hicann;
+		}
+	});
+
+	relink_chunks(filename);
+
+	LOG4CXX_DEBUG(
+		getTimeLogger(), "chunked load of " << keys.size() << " chunks took " << t.get_ms()
+		                                    << "ms");
+}
+
+void Wafer::relink_chunks(std::string const& filename)
+{
+	// restore the links, which a single tracked archive keeps by itself
+	for (auto& fpga : mFPGA) {
+		if (fpga) {
+			fpga->setCommonFPGASettings(mSharedSettings);
+		}
+	}
+	for (auto hicann_c : iter_all<HICANNOnWafer>()) {
+		auto const& hicann = mHICANN[hicann_c];
+		HICANNGlobal const hicann_global(hicann_c, mWafer);
+		auto const& fpga = mFPGA[hicann_global.toFPGAOnWafer()];
+		if (!fpga) {
+			if (hicann) {
+				throw std::runtime_error(
+					"'" + filename + "' contains " + short_format(hicann_c) + " without its FPGA");
+			}
+			continue;
+		}
+		// also drops HICANNs no longer allocated from FPGAs kept by a delta
+		fpga->add_hicann(hicann_c, hicann);
+		if (hicann) {
+			hicann->attach(fpga, this);
+		}
+	}
+}
+
+void Wafer::open_lazy(const char* const _filename)
+{
+	boost::filesystem::path filename(_filename);
+	if (!boost::filesystem::exists(filename))
+	{
+		std::string err("File '");
+		err += filename.c_str();
+		err += "' not found!";
+		throw std::runtime_error(err);
+	}
+	if (!ChunkedArchive::is_chunked_archive(filename.string())) {
+		throw std::runtime_error(
+			"'" + filename.string() + "' is no chunked dump, cf. Wafer::dump");
+	}
+	disconnect();
+	LOG4CXX_INFO(logger, "Wafer config (chunked, lazy) load from: " << filename);
+	load_chunked(filename.string(), true);
+	mLazyChunks = boost::make_shared<ChunkedArchive const>(filename.string());
+}
+
+bool Wafer::is_lazy(hicann_coord const& hicann) const
+{
+	if (!mLazyChunks) {
+		return false;
+	}
+	std::lock_guard<std::mutex> lock(mLazyMutex);
+	return mLazyChunks && !mHICANN[hicann] &&
+	       mLazyChunks->has({HICANNChunk, uint32_t(hicann.toEnum().value())});
+}
+
+void Wafer::load_lazy_hicann(hicann_coord const& hicann_c) const
+{
+	if (!is_lazy(hicann_c)) {
+		return;
+	}
+	std::istringstream stream(
+		mLazyChunks->read({HICANNChunk, uint32_t(hicann_c.toEnum().value())}));
+	boost::archive::binary_iarchive ar(stream);
+	auto hicann = boost::make_shared<HICANN>();
+	hicann->serialize_detached(ar);
+
+	std::lock_guard<std::mutex> lock(mLazyMutex);
+	if (mHICANN[hicann_c]) {
+		// loaded concurrently
+		return;
+	}
+	// only completes the configuration opened by open_lazy()
+	Wafer& self = const_cast<Wafer&>(*this);
+	auto const& fpga = self.mFPGA[HICANNGlobal(hicann_c, mWafer).toFPGAOnWafer()];
+	if (!fpga) {
+		throw std::runtime_error(
+			"'" + mLazyChunks->filename() + "' contains " + short_format(hicann_c) +
+			" without its FPGA");
+	}
+	hicann->attach(fpga, &self);
+	fpga->add_hicann(hicann_c, hicann);
+	self.mHICANN[hicann_c] = hicann;
+}
+
+void Wafer::load_lazy_hicanns() const
+{
+	if (!mLazyChunks) {
+		return;
+	}
+	auto t = Timer::from_literal_string(__PRETTY_FUNCTION__);
+	std::vector<hicann_coord> hicanns;
+	for (auto hicann_c : iter_all<HICANNOnWafer>()) {
+		if (is_lazy(hicann_c)) {
+			hicanns.push_back(hicann_c);
+		}
+	}
+	parallel_for(hicanns.size(), [this, &hicanns](size_t const ii) {
+		load_lazy_hicann(hicanns[ii]);
+	});
+	LOG4CXX_DEBUG(
+		getTimeLogger(), "lazy load of " << hicanns.size() << " HICANNs took " << t.get_ms()
+		                                 << "ms");
+}
+
+void Wafer::load_lazy_hicanns(fpga_coord const& fpga) const
+{
+	if (!mLazyChunks) {
+		return;
+	}
+	std::vector<hicann_coord> hicanns;
+	for (auto hicann_c : iter_all<HICANNOnWafer>()) {
+		if (HICANNGlobal(hicann_c, mWafer).toFPGAOnWafer() == fpga && is_lazy(hicann_c)) {
+			hicanns.push_back(hicann_c);
+		}
+	}
+	parallel_for(hicanns.size(), [this, &hicanns](size_t const ii) {
+		load_lazy_hicann(hicanns[ii]);
+	});
+}
+
+void Wafer::dump_delta(
+	const char* const base_file, const char* const filename, bool const overwrite) const
+{
+	Wafer base(mWafer);
+	base.load(base_file);
+	dump_delta(base, filename, overwrite);
+}
+
+void Wafer::dump_delta(Wafer const& base, const char* const _filename, bool const overwrite) const
+{
+	auto t = Timer::from_literal_string(__PRETTY_FUNCTION__);
+
+	boost::filesystem::path filename(_filename);
+	if (!overwrite && boost::filesystem::exists(filename))
+	{
+		std::string err("File '");
+		err += filename.c_str();
+		err += "' allready exists!";
+		throw std::runtime_error(err);
+	}
+	if (base.mWafer != mWafer) {
+		throw std::invalid_argument("Wafer::dump_delta(): base is a configuration of another wafer");
+	}
+	LOG4CXX_INFO(logger, "Wafer config delta dump to: " << filename);
+	load_lazy_hicanns();
+	base.load_lazy_hicanns();
+
+	// allocated FPGAs and HICANNs, the others are dropped when loading
+	std::vector<size_t> fpgas;
+	std::vector<size_t> hicanns;
+	ChunkedArchive::chunks_type chunks;
+	chunks.push_back({{WaferChunk, 0}, std::string()});
+	for (auto fpga_c : iter_all<FPGAOnWafer>()) {
+		if (mFPGA[fpga_c]) {
+			fpgas.push_back(fpga_c.toEnum().value());
+			chunks.push_back({{FPGAChunk, uint32_t(fpga_c.toEnum().value())}, std::string()});
+		}
+	}
+	for (auto hicann_c : iter_all<HICANNOnWafer>()) {
+		if (mHICANN[hicann_c]) {
+			hicanns.push_back(hicann_c.toEnum().value());
+			uint32_t const type = base.mHICANN[hicann_c] ? HICANNDeltaChunk : HICANNChunk;
+			chunks.push_back({{type, uint32_t(hicann_c.toEnum().value())}, std::string()});
+		}
+	}
+
+	// chunks left empty are unchanged and not written
+	parallel_for(chunks.size(), [this, &base, &chunks](size_t const ii) {
+		auto& chunk = chunks[ii];
+		std::ostringstream stream;
+		{
+			boost::archive::binary_oarchive ar(stream);
+			switch (chunk.first.type) {
+				case WaferChunk:
+					ar << mWafer << mADCChannels << mNumHICANNs << mSharedSettings << mDefects;
+					break;
+				case FPGAChunk: {
+					FPGAOnWafer const fpga_c(Enum(chunk.first.id));
+					mFPGA[fpga_c]->serialize_detached(ar);
+					if (base.mFPGA[fpga_c]) {
+						std::ostringstream base_stream;
+						{
+							boost::archive::binary_oarchive base_ar(base_stream);
+							base.mFPGA[fpga_c]->serialize_detached(base_ar);
+						}
+						stream.flush();
+						if (base_stream.str() == stream.str()) {
+							return;
+						}
+					}
+					break;
+				}
+				case HICANNChunk:
+					mHICANN[HICANNOnWafer(Enum(chunk.first.id))]->serialize_detached(ar);
+					break;
+				case HICANNDeltaChunk: {
+					HICANNOnWafer const hicann_c(Enum(chunk.first.id));
+					HICANN const& hicann = *mHICANN[hicann_c];
+					HICANN const& base_hicann = *base.mHICANN[hicann_c];
+					if (hicann == base_hicann) {
+						return;
+					}
+					HICANNDataDelta const delta(base_hicann, hicann);
+					// the delta only covers HICANNData, e.g. versions are stored in full
+					HICANN patched(base_hicann);
+					delta.apply(patched);
+					if (patched != hicann) {
+						chunk.first.type = HICANNChunk;
+						hicann.serialize_detached(ar);
+					} else {
+						ar << delta;
+					}
+					break;
+				}
+			}
+		}
+		chunk.second = stream.str();
+	});
+
+	chunks.erase(
+		std::remove_if(
+			chunks.begin(), chunks.end(),
+			[](ChunkedArchive::chunks_type::value_type const& chunk) {
+				return chunk.second.empty();
+			}),
+		chunks.end());
+	{
+		std::ostringstream stream;
+		{
+			boost::archive::binary_oarchive ar(stream);
+			ar << fpgas << hicanns;
+		}
+		chunks.push_back({{DeltaChunk, 0}, stream.str()});
+	}
+
+	ChunkedArchive::write(filename.string(), chunks);
+	LOG4CXX_DEBUG(
+		getTimeLogger(), "delta dump of " << chunks.size() << " chunks took " << t.get_ms()
+		                                  << "ms");
+}
+
+void Wafer::load(
+	const char* const base_file, std::vector<std::string> const& delta_files, bool const strict)
+{
+	load(base_file);
+	for (auto const& delta_file : delta_files) {
+		if (!boost::filesystem::exists(delta_file)) {
+			throw std::runtime_error("File '" + delta_file + "' not found!");
+		}
+		LOG4CXX_INFO(logger, "Wafer config delta load from: " << delta_file);
+		load_delta(delta_file, strict);
+	}
+}
+
+void Wafer::load_delta(std::string const& filename, bool const strict)
+{
+	auto t = Timer::from_literal_string(__PRETTY_FUNCTION__);
+
+	if (!ChunkedArchive::is_chunked_archive(filename)) {
+		throw std::runtime_error("'" + filename + "' is no wafer config delta");
+	}
+	ChunkedArchive const archive(filename);
+	if (!archive.has({DeltaChunk, 0})) {
+		throw std::runtime_error("'" + filename + "' is no wafer config delta");
+	}
+
+	std::vector<size_t> fpgas;
+	std::vector<size_t> hicanns;
+	{
+		std::istringstream stream(archive.read({DeltaChunk, 0}));
+		boost::archive::binary_iarchive ar(stream);
+		ar >> fpgas >> hicanns;
+	}
+	{
+		std::istringstream stream(archive.read({WaferChunk, 0}));
+		boost::archive::binary_iarchive ar(stream);
+		wafer_coord wafer;
+		ar >> wafer;
+		if (wafer != mWafer) {
+			throw std::runtime_error(
+				"'" + filename + "' is a delta for another wafer than its base");
+		}
+		ar >> mADCChannels >> mNumHICANNs >> mSharedSettings >> mDefects;
+	}
+
+	// drop FPGAs and HICANNs not allocated anymore
+	typed_array<bool, FPGAOnWafer> keep_fpga;
+	keep_fpga.fill(false);
+	for (auto const fpga : fpgas) {
+		keep_fpga[FPGAOnWafer(Enum(fpga))] = true;
+	}
+	for (auto fpga_c : iter_all<FPGAOnWafer>()) {
+		if (!keep_fpga[fpga_c]) {
+			mFPGA[fpga_c].reset();
+		}
+	}
+	typed_array<bool, HICANNOnWafer> keep_hicann;
+	keep_hicann.fill(false);
+	for (auto const hicann : hicanns) {
+		keep_hicann[HICANNOnWafer(Enum(hicann))] = true;
+	}
+	for (auto hicann_c : iter_all<HICANNOnWafer>()) {
+		if (!keep_hicann[hicann_c]) {
+			mHICANN[hicann_c].reset();
+		}
+	}
+
+	std::vector<ChunkedArchive::Key> keys = archive.keys();
+	parallel_for(keys.size(), [this, &archive, &keys, &filename, strict](size_t const ii) {
+		auto const& key = keys[ii];
+		if (key.type != FPGAChunk && key.type != HICANNChunk && key.type != HICANNDeltaChunk) {
+			return;
+		}
+		std::istringstream stream(archive.read(key));
+		boost::archive::binary_iarchive ar(stream);
+		// each chunk is written by a single thread, the arrays are not resized
+		if (key.type == FPGAChunk) {
+			auto fpga = boost::make_shared<FPGA>();
+			fpga->serialize_detached(ar);
+			mFPGA[FPGAOnWafer(Enum(key.id))] = fpga;
+		} else if (key.type == HICANNChunk) {
+			auto hicann = boost::make_shared<HICANN>();
+			hicann->serialize_detached(ar);
+			mHICANN[HICANNOnWafer(Enum(key.id))] = hicann;
+		} else {
+			HICANNOnWafer const hicann_c(Enum(key.id));
+			if (!mHICANN[hicann_c]) {
+				throw std::runtime_error(
+					"'" + filename + "' contains a delta for " + short_format(hicann_c) +
+					", which is not allocated in its base");
+			}
+			HICANNDataDelta delta;
+			ar >> delta;
+			delta.apply(*mHICANN[hicann_c], strict);
+		}
+	});
+
+	relink_chunks(filename);
+
+	LOG4CXX_DEBUG(
+		getTimeLogger(), "delta load of " << keys.size() << " chunks took " << t.get_ms()
+		                                  << "ms");
+}
+
 boost::shared_ptr<FPGAShared> Wafer::commonFPGASettings()
 {
 	return mSharedSettings;
@@ -846,8 +1497,34 @@ void Wafer::note_systime_start(HICANNConfigurator& configurator)
 	smart_configurator->note_systime_start();
 }
 
+void Wafer::load_smart_configurator_state()
+{
+	std::string const& directory = Settings::get().smart_configurator_state_dir;
+	if (directory.empty()) {
+		return;
+	}
+
+	mStateStore = boost::make_shared<SmartConfiguratorStateStore>(directory, mWafer);
+	mStateKey = SmartConfiguratorStateStore::key(status());
+
+	// the key only identifies the hardware, not whether it has been reset or
+	// reconfigured by others since the state was stored
+	if (!Settings::get().trust_smart_configurator_state) {
+		LOG4CXX_INFO(
+			logger, "Not taking over stored smart configurator state, set "
+			        "Settings::trust_smart_configurator_state to do so");
+		return;
+	}
+
+	auto state = ParallelHICANNv4SmartConfigurator::create();
+	if (mStateStore->load(mStateKey, *state)) {
+		mStoredSmartState = state;
+	}
+}
+
 std::ostream& operator<<(std::ostream& out, Wafer const& obj)
 {
+	obj.load_lazy_hicanns();
 	out << obj.mWafer << ":" << std::endl;
 	out << "- FPGA handles: ";
 	for (auto it : obj.mFPGA) {
@@ -869,6 +1546,11 @@ template<typename Archiver>
 void Wafer::serialize(Archiver & ar, unsigned int const version)
 {
 	using boost::serialization::make_nvp;
+	if (typename Archiver::is_saving()) {
+		load_lazy_hicanns();
+	} else {
+		mLazyChunks.reset();
+	}
 	ar & make_nvp("wafer", mWafer);
 	// When loading version 1 archives with array size != 12 special care is needed
 	// saving is handeled by the definition of the archive version
@@ -907,6 +1589,9 @@ void Wafer::serialize(Archiver & ar, unsigned int const version)
 
 bool operator==(Wafer const& a, Wafer const& b)
 {
+	a.load_lazy_hicanns();
+	b.load_lazy_hicanns();
+
 	// boost::shared_ptr does not support reasonable comparisons...
 	for (auto i : iter_all<FPGAOnWafer>()) {
 		if (static_cast<bool>(a.mFPGA[i]) != static_cast<bool>(b.mFPGA[i])) {
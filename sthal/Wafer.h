@@ -7,6 +7,9 @@
 #undef __ATOMIC_RELEASE
 #endif // PYPLUSPLUS
 #include <boost/shared_ptr.hpp>
+#ifndef PYPLUSPLUS
+#include <mutex>
+#endif // PYPLUSPLUS
 
 // GCCXML has problems with atomics -> removed before log4cxx provisionnode is included
 #ifdef PYPLUSPLUS
@@ -27,6 +30,8 @@ typedef boost::shared_ptr<log4cxx::Logger> LoggerPtr;
 
 #include "sthal/FPGA.h"
 #include "sthal/HICANN.h"
+#include "sthal/ExperimentRunner.h"
+#include "sthal/SmartConfiguratorStateStore.h"
 #include "sthal/Status.h"
 
 #include "redman/resources/Wafer.h"
@@ -39,9 +44,10 @@ class access;
 
 namespace sthal {
 
+class ChunkedArchive;
 class HardwareDatabase;
-class ExperimentRunner;
 class HICANNConfigurator;
+class ParallelHICANNv4SmartConfigurator;
 
 class Wafer : private boost::noncopyable
 {
@@ -80,6 +86,11 @@ public:
 	wafer_coord const& index() const;
 
 	/// Gets handle
+	/// @note if Settings::smart_configurator_state_dir is set, the smart configurator
+	///       state of this wafer is stored after each configuration. If additionally
+	///       Settings::trust_smart_configurator_state is set, the stored state is loaded
+	///       and taken over by the next ParallelHICANNv4SmartConfigurator without state
+	///       passed to configure(). The systime counters are always started again.
 	void connect(const HardwareDatabase & db);
 
 	/// Frees handle
@@ -89,6 +100,8 @@ public:
 	void configure();
 
 	/// Write complete configuration
+	/// @note the state of a smart configurator is stored after a successful
+	///       configuration, cf. connect()
 	void configure(HICANNConfigurator & configurator);
 
 	/// Write pulses and start experiment
@@ -97,6 +110,10 @@ public:
 	/// Restart experiment, same as start, but clears received spikes
 	void restart(ExperimentRunner & runner);
 
+	/// Run one experiment per stimulus on the current configuration,
+	/// see ExperimentRunner::run_batch
+	batch_pulse_events run_batch(ExperimentRunner & runner, batch_pulse_events const& stimuli);
+
 	/// returns number of allocated hicanns
 	size_t allocated() const;
 
@@ -117,15 +134,50 @@ public:
 	void clearSpikes(bool received = true, bool send = true);
 
 	/// Dumps the current configuration into a file
+	/// Files ending on ".xml" are written as xml archive, files ending on ".chunked"
+	/// in a chunked format, in which the FPGAs and HICANNs are serialized in
+	/// parallel into independent chunks (cf. ChunkedArchive), all others as binary
+	/// archive.
+	/// Xml and binary archives are compressed if the file name has an additional
+	/// extension ".gz", ".bz2" or ".zst" (boost >= 1.79), e.g. "wafer.xml.gz".
 	/// @note the hardware connection cannot be dumped
 	void dump(const char * const filename, bool overwrite = false) const;
 	/// alias to dump
 	void save(const char * const filename, bool overwrite = false) const;
 
 	/// Loads a wafer config from a saved
+	/// The chunked format is detected by the file content, its chunks are
+	/// deserialized in parallel. The compression is selected by extension as for dump().
 	/// @note after loading the wafer will be disconnected
 	void load(const char * const filename);
 
+	/// Opens a chunked dump (cf. dump()) without deserializing its HICANNs. Each HICANN
+	/// is loaded on first access by operator[], the ones of an FPGA on access to the
+	/// FPGA, all remaining ones when connecting, dumping or comparing the wafer.
+	/// @note after loading the wafer will be disconnected
+	void open_lazy(const char * const filename);
+
+	/// Dumps the differences of the current configuration to base into a file.
+	/// Changed HICANNs are stored as HICANNDataDelta, i.e. only the changed blocks,
+	/// synapse rows and FG blocks, the FPGAs and wafer-level settings as a whole.
+	/// The file is a chunked archive (cf. dump()) and can only be loaded together
+	/// with its base, cf. load(base_file, delta_files).
+	void dump_delta(Wafer const& base, const char * const filename, bool overwrite = false) const;
+	/// Dumps the differences to the configuration dumped into base_file
+	void dump_delta(
+		const char * const base_file, const char * const filename, bool overwrite = false) const;
+
+	/// Loads the configuration from base_file and applies the deltas in order.
+	/// Each delta has to be taken relative to the configuration of its predecessors,
+	/// which is checked per HICANN by content hash. Mismatches are warnings, unless
+	/// strict is set. Deltas written with another archive layout of the HICANN blocks
+	/// are applied unchecked, cf. HICANNDataDelta::apply().
+	/// @note after loading the wafer will be disconnected
+	void load(
+		const char * const base_file,
+		std::vector<std::string> const& delta_files,
+		bool strict = false);
+
 	/// Get settings shared between all FPGAs
 	boost::shared_ptr<FPGAShared> commonFPGASettings();
 
@@ -158,12 +210,52 @@ private:
 	 */
 	void configure_l1_bus_locking(HICANNConfigurator& configurator);
 
+	/*
+	 * Resets/configures all allocated FPGAs and starts their systime counters
+	 * in one parallel region, cf. FPGABringUp.
+	 */
+	void configure_fpgas(HICANNConfigurator& configurator);
+
+	/*
+	 * Group id for each of the given FPGAs, FPGAs with L1-adjacent allocated HICANNs
+	 * (directly or transitively) share a group, cf. ConfigurationScheduler.
+	 */
+	std::vector<size_t> l1_groups(std::vector<fpga_coord> const& fpgas) const;
+
 	/*
 	 * Only relevant if the configurator is smart. Tells the smart configurator that systime
 	 * has been started on all allocated FPGAs. Not thread-safe!
 	 */
 	void note_systime_start(HICANNConfigurator& configurator);
 
+	/*
+	 * Loads the smart configurator state stored for the connected hardware, if enabled
+	 * in the settings.
+	 */
+	void load_smart_configurator_state();
+
+	/*
+	 * Chunked dump format, cf. dump(). The wafer-level members, each FPGA and each
+	 * HICANN are serialized into independent chunks, the links between FPGAs, HICANNs
+	 * and the wafer are restored when loading.
+	 */
+	void dump_chunked(std::string const& filename) const;
+	void load_chunked(std::string const& filename, bool lazy = false);
+	// applies a delta written by dump_delta() to the current configuration
+	void load_delta(std::string const& filename, bool strict);
+	// restores the links between FPGAs, HICANNs and the wafer after chunked loading
+	void relink_chunks(std::string const& filename);
+
+	/*
+	 * HICANNs of a wafer opened by open_lazy(). Loading them keeps the logical state
+	 * of the wafer, hence these are const.
+	 */
+	void load_lazy_hicann(hicann_coord const& hicann) const;
+	void load_lazy_hicanns() const;
+	// HICANNs of the given FPGA, so that FPGA-level accessors see all of them
+	void load_lazy_hicanns(fpga_coord const& fpga) const;
+	bool is_lazy(hicann_coord const& hicann) const;
+
 	wafer_coord mWafer;
 	halco::common::typed_array<fpga_t,          fpga_coord>   mFPGA;
 	halco::common::typed_array<fpga_handle_t,   fpga_coord>   mFPGAHandle;
@@ -174,6 +266,16 @@ private:
 	boost::shared_ptr<FPGAShared> mSharedSettings;
 #ifndef PYPLUSPLUS
 	boost::shared_ptr<const HardwareDatabase> mHardwareDatabase;
+
+	// persistent smart configurator state, only set while connected and if enabled
+	boost::shared_ptr<SmartConfiguratorStateStore> mStateStore;
+	SmartConfiguratorStateStore::Key mStateKey;
+	// state loaded on connect, not yet taken over by a configurator
+	boost::shared_ptr<ParallelHICANNv4SmartConfigurator> mStoredSmartState;
+
+	// dump opened by open_lazy(), HICANNs not allocated yet are loaded from it
+	boost::shared_ptr<ChunkedArchive const> mLazyChunks;
+	mutable std::mutex mLazyMutex;
 #endif
 
 	friend class boost::serialization::access;
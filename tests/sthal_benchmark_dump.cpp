@@ -0,0 +1,108 @@
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include "halco/common/iter_all.h"
+#include "sthal/Timer.h"
+#include "sthal/Wafer.h"
+
+namespace po = boost::program_options;
+using namespace halco::hicann::v2;
+using namespace halco::common;
+
+// Compares the dump formats of sthal::Wafer by dump/load throughput and file size on
+// a synthetic wafer. The throughput refers to the size of the uncompressed binary dump.
+int main(int argc, char* argv[]) {
+	size_t no_hicanns, no_rounds;
+	double density;
+	int seed;
+	std::string directory;
+
+	po::options_description bpo_desc("Allowed options");
+	bpo_desc.add_options()
+		("help", "produce help message")
+		("num_hicanns,n", po::value<size_t>(&no_hicanns)->default_value(HICANNOnWafer::size), "set number of allocated HICANNs")
+		("rounds,r", po::value<size_t>(&no_rounds)->default_value(3), "set number of dump/load rounds per format")
+		("density,d", po::value<double>(&density)->default_value(0.1), "fraction of synapses with nonzero weight")
+		("seed,s", po::value<int>(&seed)->default_value(123), "seed for random configuration")
+		("directory", po::value<std::string>(&directory)->default_value(
+			boost::filesystem::temp_directory_path().string()), "directory for the dumps");
+
+	po::variables_map parse;
+	po::store(po::parse_command_line(argc, argv, bpo_desc), parse);
+	po::notify(parse);
+
+	if (parse.count("help")) {
+		std::cout << bpo_desc << "\n";
+		return 1;
+	}
+
+	std::mt19937 gen(seed);
+	std::bernoulli_distribution used(density);
+	std::uniform_int_distribution<size_t> weight(1, 15);
+	std::uniform_int_distribution<size_t> decoder(0, 3);
+	std::uniform_int_distribution<int> fg_value(0, 1023);
+
+	sthal::Wafer wafer(Wafer(Enum(33)));
+	for (auto hicann_c : iter_all<HICANNOnWafer>()) {
+		if (hicann_c.toEnum().value() >= no_hicanns) {
+			break;
+		}
+		sthal::HICANN& hicann = wafer[hicann_c];
+		for (auto synapse : iter_all<SynapseOnHICANN>()) {
+			if (used(gen)) {
+				hicann.synapses[synapse].weight = HMF::HICANN::SynapseWeight(weight(gen));
+				hicann.synapses[synapse].decoder = HMF::HICANN::SynapseDecoder(decoder(gen));
+			}
+		}
+		for (auto neuron : iter_all<NeuronOnHICANN>()) {
+			hicann.floating_gates.setNeuron(neuron, HMF::HICANN::E_l, fg_value(gen));
+			hicann.floating_gates.setNeuron(neuron, HMF::HICANN::V_t, fg_value(gen));
+		}
+	}
+
+	boost::filesystem::path const prefix =
+		boost::filesystem::path(directory) /
+		boost::filesystem::unique_path("sthal-benchmark-dump-%%%%-%%%%");
+	double raw_size = 0.;
+	for (std::string const extension :
+	     {".bin", ".bin.gz", ".bin.bz2", ".bin.zst", ".xml", ".xml.gz", ".chunked"}) {
+		std::string const filename = prefix.string() + extension;
+		double t_dump = 0.;
+		double t_load = 0.;
+		try {
+			for (size_t round = 0; round < no_rounds; ++round) {
+				{
+					sthal::Timer t;
+					wafer.dump(filename.c_str(), true);
+					t_dump += t.get_ms();
+				}
+				sthal::Wafer loaded(Wafer(Enum(33)));
+				sthal::Timer t;
+				loaded.load(filename.c_str());
+				t_load += t.get_ms();
+			}
+		} catch (std::runtime_error const& err) {
+			std::cout << extension << ": not supported (" << err.what() << ")" << std::endl;
+			boost::filesystem::remove(filename);
+			continue;
+		}
+
+		double const size = boost::filesystem::file_size(filename);
+		boost::filesystem::remove(filename);
+		if (raw_size == 0.) {
+			raw_size = size;
+		}
+		double const mb = raw_size / (1024. * 1024.);
+		std::cout << extension << ": " << size / (1024. * 1024.) << " MiB (ratio "
+		          << raw_size / size << "), dump " << mb / (t_dump / no_rounds / 1000.)
+		          << " MiB/s, load " << mb / (t_load / no_rounds / 1000.) << " MiB/s"
+		          << std::endl;
+	}
+	return EXIT_SUCCESS;
+}
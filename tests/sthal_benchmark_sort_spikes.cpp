@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+#include <boost/program_options.hpp>
+
+#include "halco/common/iter_all.h"
+#include "sthal/FPGA.h"
+#include "sthal/Spike.h"
+#include "sthal/Timer.h"
+
+namespace po = boost::program_options;
+using namespace halco::hicann::v2;
+using namespace halco::common;
+
+// Compares FPGA::sortSpikes (sort pending spikes, merge with sorted ones) with the
+// previous implementation (append sorted spikes to pending ones and sort everything)
+// for repeated incremental additions of spikes. Both include the construction of the
+// PulseEventContainer, whose cost for already sorted events is reported separately.
+int main(int argc, char* argv[]) {
+	size_t no_spikes, no_rounds;
+	int seed;
+
+	po::options_description bpo_desc("Allowed options");
+	bpo_desc.add_options()
+		("help", "produce help message")
+		("num_spikes,n", po::value<size_t>(&no_spikes)->default_value(1000000), "set number of spikes added per round")
+		("rounds,r", po::value<size_t>(&no_rounds)->default_value(5), "set number of rounds of adding spikes")
+		("seed,s", po::value<int>(&seed)->default_value(123), "seed for random spike times");
+
+	po::variables_map parse;
+	po::store(po::parse_command_line(argc, argv, bpo_desc), parse);
+	po::notify(parse);
+
+	if (parse.count("help")) {
+		std::cout << bpo_desc << "\n";
+		return 1;
+	}
+
+	FPGAGlobal const fpga_c(FPGAOnWafer(Enum(0)), Wafer(Enum(0)));
+	std::vector<HICANNOnWafer> hicanns;
+	for (auto hicann : iter_all<HICANNOnDNC>()) {
+		hicanns.push_back(hicann.toHICANNOnWafer(fpga_c));
+	}
+
+	std::mt19937 gen(seed);
+	std::uniform_real_distribution<double> time(0., 1e-2);
+	std::uniform_int_distribution<size_t> addr(0, 63);
+
+	sthal::FPGA merging(fpga_c);
+	sthal::FPGA::pulse_event_container_type resorted;
+
+	double t_merge = 0., t_resort = 0., t_container = 0.;
+	for (size_t round = 0; round < no_rounds; ++round) {
+		sthal::FPGA::pulse_event_container_type events;
+		events.reserve(no_spikes);
+		for (size_t ii = 0; ii < no_spikes; ++ii) {
+			HICANNGlobal const hicann(hicanns[ii % hicanns.size()], fpga_c.toWafer());
+			events.push_back(sthal::FPGA::PulseEvent(
+				sthal::FPGA::PulseEvent::dnc_address_t(hicann.toDNCOnFPGA().value()),
+				sthal::FPGA::PulseEvent::chip_address_t(hicann.toHICANNOnDNC().toEnum()),
+				sthal::FPGA::PulseEvent::channel_t(ii % GbitLinkOnHICANN::size),
+				HMF::HICANN::L1Address(addr(gen)), size_t(time(gen) * sthal::FPGA::dnc_freq)));
+		}
+
+		{
+			sthal::FPGA::SpikeBatchWriter writer(merging, events.size());
+			for (auto const& event : events) {
+				writer.add(event);
+			}
+			writer.commit();
+		}
+
+		{
+			sthal::Timer t;
+			merging.sortSpikes();
+			t_merge += t.get_ms();
+		}
+
+		// previous implementation of sortSpikes
+		sthal::Timer t;
+		events.reserve(events.size() + resorted.size());
+		std::copy(resorted.begin(), resorted.end(), std::back_inserter(events));
+		sthal::FPGA::PulseEventContainer const container(std::move(events));
+		t_resort += t.get_ms();
+		resorted = container.data();
+
+		// construction from events in time order, part of both implementations
+		{
+			sthal::FPGA::pulse_event_container_type sorted = resorted;
+			sthal::Timer t;
+			sthal::FPGA::PulseEventContainer const sorted_container(std::move(sorted));
+			t_container += t.get_ms();
+		}
+
+		std::cout << "round " << round << ": " << merging.getSendSpikes().size()
+		          << " spikes, merge " << t_merge << " ms, full re-sort " << t_resort
+		          << " ms, thereof container of sorted events " << t_container
+		          << " ms (accumulated)" << std::endl;
+	}
+
+	auto const& merged = merging.getSendSpikes().data();
+	bool const same_order = std::equal(
+		merged.begin(), merged.end(), resorted.begin(), resorted.end(),
+		[](sthal::FPGA::PulseEvent const& a, sthal::FPGA::PulseEvent const& b) {
+			return a.getTime() == b.getTime();
+		});
+	if (!same_order) {
+		std::cerr << "spike times differ between both implementations" << std::endl;
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
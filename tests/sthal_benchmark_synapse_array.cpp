@@ -0,0 +1,127 @@
+#include <array>
+#include <iostream>
+#include <random>
+
+#include <boost/make_shared.hpp>
+#include <boost/program_options.hpp>
+
+#include "halco/common/iter_all.h"
+#include "sthal/HICANNData.h"
+#include "sthal/ParallelHICANNv4Configurator.h"
+#include "sthal/Timer.h"
+
+namespace po = boost::program_options;
+using namespace halco::hicann::v2;
+using namespace halco::common;
+
+namespace {
+
+// Replaces the hardware access of the configurator by bookkeeping of the issued
+// commands per synapse controller. The HICANN handles are never dereferenced.
+class MockSynapseConfigurator : public sthal::ParallelHICANNv4Configurator
+{
+public:
+	void write_decoder_double_row(
+		hicann_handles_t const& handles,
+		std::vector< ::HMF::HICANN::SynapseController> const& /*synapse_controllers*/,
+		SynapseDriverOnHICANN const& syndrv,
+		std::vector< ::HMF::HICANN::DecoderDoubleRow> const& /*data*/) override
+	{
+		issue(syndrv.toSynapseArrayOnHICANN(), handles.size());
+	}
+
+	void write_weights_row(
+		hicann_handles_t const& handles,
+		std::vector< ::HMF::HICANN::SynapseController> const& /*synapse_controllers*/,
+		SynapseRowOnHICANN const& synrow,
+		std::vector< ::HMF::HICANN::WeightRow> const& /*data*/) override
+	{
+		issue(synrow.toSynapseDriverOnHICANN().toSynapseArrayOnHICANN(), handles.size());
+	}
+
+	void reset()
+	{
+		commands.fill(0);
+		switches = 0;
+		calls = 0;
+	}
+
+	std::array<size_t, SynapseArrayOnHICANN::size> commands{};
+	/// number of consecutive calls targeting a different controller than the previous one
+	size_t switches = 0;
+	size_t calls = 0;
+
+private:
+	void issue(SynapseArrayOnHICANN const& array, size_t n_hicanns)
+	{
+		size_t const controller = array.toEnum().value();
+		if (calls != 0 && controller != m_last) {
+			++switches;
+		}
+		m_last = controller;
+		commands[controller] += n_hicanns;
+		++calls;
+	}
+
+	size_t m_last = 0;
+};
+
+} // namespace
+
+// Compares the synapse driver orders of ParallelHICANNv4Configurator::config_synapse_array
+// by the host-side time and the sequence of commands issued to the synapse controllers.
+int main(int argc, char* argv[]) {
+	size_t no_hicanns, no_rounds;
+	int seed;
+
+	po::options_description bpo_desc("Allowed options");
+	bpo_desc.add_options()
+		("help", "produce help message")
+		("num_hicanns,n", po::value<size_t>(&no_hicanns)->default_value(8), "set number of HICANNs behind the FPGA")
+		("rounds,r", po::value<size_t>(&no_rounds)->default_value(20), "set number of configuration rounds")
+		("seed,s", po::value<int>(&seed)->default_value(123), "seed for random weights");
+
+	po::variables_map parse;
+	po::store(po::parse_command_line(argc, argv, bpo_desc), parse);
+	po::notify(parse);
+
+	if (parse.count("help")) {
+		std::cout << bpo_desc << "\n";
+		return 1;
+	}
+
+	std::mt19937 gen(seed);
+	std::uniform_int_distribution<size_t> weight(0, 15);
+
+	MockSynapseConfigurator::hicann_handles_t handles(no_hicanns);
+	MockSynapseConfigurator::hicann_datas_t hicanns;
+	for (size_t ii = 0; ii < no_hicanns; ++ii) {
+		auto data = boost::make_shared<sthal::HICANNData>();
+		for (auto synapse : iter_all<SynapseOnHICANN>()) {
+			data->synapses[synapse].weight = HMF::HICANN::SynapseWeight(weight(gen));
+		}
+		hicanns.push_back(data);
+	}
+
+	typedef sthal::ParallelHICANNv4Configurator::SynapseWriteOrder order_t;
+	for (auto order : {order_t::Sequential, order_t::Alternating}) {
+		MockSynapseConfigurator configurator;
+		configurator.setSynapseWriteOrder(order);
+
+		double t_config = 0.;
+		for (size_t round = 0; round < no_rounds; ++round) {
+			configurator.reset();
+			sthal::Timer t;
+			configurator.config_synapse_array(handles, hicanns);
+			t_config += t.get_ms();
+		}
+
+		std::cout << (order == order_t::Sequential ? "sequential" : "alternating") << ": "
+		          << configurator.calls << " calls, "
+		          << configurator.commands[0] << "/" << configurator.commands[1]
+		          << " commands (top/bottom), " << configurator.switches
+		          << " controller switches, " << t_config / no_rounds << " ms per round"
+		          << std::endl;
+	}
+	return EXIT_SUCCESS;
+}
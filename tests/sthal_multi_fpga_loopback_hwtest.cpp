@@ -161,7 +161,7 @@ int main(int argc, char* argv[]) {
 	std::vector<double> first_spikes;
 	//read out of spike events per FPGA
 	for(std::vector< ::halco::hicann::v2::FPGAOnWafer>::iterator fpga_it = fpgas.begin(); fpga_it != fpgas.end(); ++fpga_it) {
-		const ::HMF::FPGA::PulseEventContainer & received_spikes = wafer[*fpga_it].getReceivedSpikes();
+		::sthal::PulseEventView const received_spikes = wafer[*fpga_it].getReceivedSpikes();
 		const ::HMF::FPGA::PulseEventContainer & sent_spikes = wafer[*fpga_it].getSendSpikes();
 		if(received_spikes.size() != sent_spikes.size()) {
 			LOG4CXX_ERROR(test_logger, "FPGA " << fpga_it->value() << " unexpected spike count, received: "
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+
+#include "sthal/AsyncExperimentRunner.h"
+
+namespace sthal {
+
+TEST(AsyncExperimentRunner, PipelineOrder)
+{
+	size_t const n_fpgas = 4;
+	std::atomic<size_t> prepared(0), started(0), read(0);
+	std::atomic<size_t> early_starts(0), early_readouts(0);
+
+	AsyncExperimentRunner::run_pipeline(
+	    n_fpgas, [&](size_t) { ++prepared; },
+	    [&](size_t) {
+		    if (prepared != n_fpgas) {
+			    ++early_starts;
+		    }
+		    ++started;
+	    },
+	    [&](size_t) {
+		    if (started != n_fpgas) {
+			    ++early_readouts;
+		    }
+		    ++read;
+	    });
+
+	EXPECT_EQ(n_fpgas, prepared);
+	EXPECT_EQ(n_fpgas, started);
+	EXPECT_EQ(n_fpgas, read);
+	// start is the global synchronisation point
+	EXPECT_EQ(0, early_starts);
+	EXPECT_EQ(0, early_readouts);
+}
+
+TEST(AsyncExperimentRunner, RethrowsAfterJoiningAllTasks)
+{
+	size_t const n_fpgas = 4;
+	std::atomic<size_t> prepared(0), started(0), read(0);
+
+	EXPECT_THROW(
+	    AsyncExperimentRunner::run_pipeline(
+	        n_fpgas,
+	        [&](size_t fpga) {
+		        if (fpga == 1) {
+			        throw std::runtime_error("prepare failed");
+		        }
+		        ++prepared;
+	        },
+	        [&](size_t) { ++started; }, [&](size_t) { ++read; }),
+	    std::runtime_error);
+	// the other FPGAs have been prepared, none of them started
+	EXPECT_EQ(n_fpgas - 1, prepared);
+	EXPECT_EQ(0, started);
+	EXPECT_EQ(0, read);
+
+	started = 0;
+	EXPECT_THROW(
+	    AsyncExperimentRunner::run_pipeline(
+	        n_fpgas, [](size_t) {},
+	        [&](size_t fpga) {
+		        ++started;
+		        if (fpga == 2) {
+			        throw std::logic_error("start failed");
+		        }
+	        },
+	        [&](size_t) { ++read; }),
+	    std::logic_error);
+	EXPECT_EQ(n_fpgas, started);
+	EXPECT_EQ(0, read);
+}
+
+} // sthal
@@ -0,0 +1,238 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+extern "C" {
+#include <omp.h>
+}
+
+#include "sthal/ConfigurationScheduler.h"
+#include "sthal/FPGABringUp.h"
+#include "sthal/ParallelHICANNv4SmartConfigurator.h"
+
+using namespace halco::hicann::v2;
+using namespace halco::common;
+
+namespace sthal {
+
+namespace {
+
+typedef std::pair<size_t, ConfigurationStage> event_t;
+typedef std::chrono::steady_clock clock_type;
+
+struct Recording
+{
+	std::vector<event_t> finished;
+	std::map<event_t, clock_type::time_point> start_times;
+	std::map<event_t, clock_type::time_point> finish_times;
+};
+
+/**
+ * Runs the scheduler and records the order in which nodes finish.
+ * The TIMING_UNCRITICAL stage of `blocked_fpga` does not finish before `release` has
+ * finished, the timeout only turns a scheduler that never releases it into a failure.
+ */
+Recording run_and_record(
+    Settings::CfgStages const& stages,
+    std::vector<size_t> const& groups,
+    size_t blocked_fpga,
+    event_t const& release)
+{
+	std::mutex mutex;
+	std::condition_variable cv;
+	Recording recording;
+	ConfigurationScheduler scheduler(stages, groups);
+	scheduler.run([&](size_t fpga, ConfigurationStage stage) {
+		event_t const event(fpga, stage);
+		std::unique_lock<std::mutex> lock(mutex);
+		recording.start_times[event] = clock_type::now();
+		if (fpga == blocked_fpga && stage == ConfigurationStage::TIMING_UNCRITICAL) {
+			cv.wait_for(lock, std::chrono::seconds(10), [&recording, &release] {
+				return recording.finish_times.count(release);
+			});
+		}
+		recording.finished.push_back(event);
+		recording.finish_times[event] = clock_type::now();
+		cv.notify_all();
+	});
+	return recording;
+}
+
+/// Sets the number of OpenMP threads and restores the previous one on destruction
+class ScopedNumThreads
+{
+public:
+	explicit ScopedNumThreads(int const n) : m_previous(omp_get_max_threads())
+	{
+		omp_set_num_threads(n);
+	}
+
+	~ScopedNumThreads()
+	{
+		omp_set_num_threads(m_previous);
+	}
+
+	ScopedNumThreads(ScopedNumThreads const&) = delete;
+	ScopedNumThreads& operator=(ScopedNumThreads const&) = delete;
+
+private:
+	int const m_previous;
+};
+
+size_t position(std::vector<event_t> const& events, event_t const& event)
+{
+	return std::find(events.begin(), events.end(), event) - events.begin();
+}
+
+} // namespace
+
+TEST(ConfigurationScheduler, IndependentGroups)
+{
+	ScopedNumThreads const threads(2);
+	Settings::CfgStages const stages;
+
+	// FPGA 1 is held in TIMING_UNCRITICAL until FPGA 0 has finished all its stages
+	auto const events =
+	    run_and_record(stages, {0, 1}, 1, event_t(0, stages.order.back())).finished;
+	ASSERT_EQ(2 * stages.order.size(), events.size());
+
+	// FPGA 0 is not coupled to FPGA 1 and does not wait for its blocked stage
+	EXPECT_LT(
+	    position(events, event_t(0, stages.order.back())),
+	    position(events, event_t(1, ConfigurationStage::TIMING_UNCRITICAL)));
+
+	// stage order is kept per FPGA
+	for (size_t fpga : {0, 1}) {
+		for (size_t ii = 1; ii < stages.order.size(); ++ii) {
+			EXPECT_LT(
+			    position(events, event_t(fpga, stages.order[ii - 1])),
+			    position(events, event_t(fpga, stages.order[ii])));
+		}
+	}
+}
+
+TEST(ConfigurationScheduler, CoupledGroup)
+{
+	ScopedNumThreads const threads(2);
+	Settings::CfgStages stages;
+	stages.sleeps[ConfigurationStage::TIMING_UNCRITICAL] = 20;
+
+	// FPGA 1 finishes TIMING_UNCRITICAL only after FPGA 0 has, from then on FPGA 0
+	// could lock its repeaters if it did not depend on FPGA 1
+	event_t const sender(1, ConfigurationStage::TIMING_UNCRITICAL);
+	event_t const locking(0, ConfigurationStage::LOCKING_REPEATER_BLOCKS);
+	auto const recording =
+	    run_and_record(stages, {0, 0}, 1, event_t(0, ConfigurationStage::TIMING_UNCRITICAL));
+	auto const& events = recording.finished;
+	ASSERT_EQ(2 * stages.order.size(), events.size());
+
+	// repeater locking of FPGA 0 waits for the L1 senders on FPGA 1 and their settle time
+	EXPECT_LT(position(events, sender), position(events, locking));
+	EXPECT_GE(
+	    recording.start_times.at(locking) - recording.finish_times.at(sender),
+	    std::chrono::milliseconds(stages.sleeps[ConfigurationStage::TIMING_UNCRITICAL]));
+}
+
+TEST(ConfigurationScheduler, InvalidDependency)
+{
+	Settings::CfgStages stages;
+	stages.l1_dependencies[ConfigurationStage::TIMING_UNCRITICAL] = {ConfigurationStage::NEURONS};
+	EXPECT_THROW(ConfigurationScheduler(stages, {0, 0}), std::invalid_argument);
+}
+
+TEST(FPGABringUp, SmartConfiguratorWithAddedFPGA)
+{
+	// with a single thread, all steps of FPGA 0 would run before FPGA 1 is configured
+	// if the phases were not separated
+	ScopedNumThreads const threads(1);
+
+	// FPGA 0 has been configured and started before, FPGA 1 is new
+	std::vector<FPGAOnWafer> const fpgas{FPGAOnWafer(Enum(0)), FPGAOnWafer(Enum(1))};
+	ParallelHICANNv4SmartConfigurator configurator;
+	configurator.note_fpga_config(fpgas[0]);
+	configurator.note_systime_start();
+	EXPECT_FALSE(configurator.systime_start_wanted());
+
+	std::mutex mutex;
+	std::vector<std::pair<std::string, size_t> > steps;
+	auto const record = [&](std::string const& step, size_t fpga) {
+		std::lock_guard<std::mutex> lock(mutex);
+		steps.push_back(std::make_pair(step, fpga));
+	};
+	auto const systime_step = [&](std::string const& step) {
+		return [&configurator, &record, step](size_t fpga) {
+			if (configurator.systime_start_wanted()) {
+				record(step, fpga);
+			}
+		};
+	};
+
+	FPGABringUp bring_up;
+	bring_up.is_master = [](size_t fpga) { return fpga == 0; };
+	// ParallelHICANNv4SmartConfigurator::config_fpga without hardware access
+	bring_up.config = [&](size_t fpga) {
+		if (configurator.fpga_config_wanted(fpgas[fpga])) {
+			std::lock_guard<std::mutex> lock(mutex);
+			configurator.note_fpga_config(fpgas[fpga]);
+			steps.push_back(std::make_pair("config", fpga));
+		}
+	};
+	bring_up.disable_global = systime_step("disable");
+	bring_up.prime_systime_counter = systime_step("prime");
+	bring_up.start_systime_counter = systime_step("start");
+	bring_up.run(fpgas.size());
+
+	auto const position = [&steps](std::string const& step, size_t fpga) {
+		return std::find(steps.begin(), steps.end(), std::make_pair(step, fpga)) - steps.begin();
+	};
+	auto const count = [&steps](std::string const& step) {
+		return std::count_if(
+		    steps.begin(), steps.end(),
+		    [&step](std::pair<std::string, size_t> const& s) { return s.first == step; });
+	};
+
+	// only the new FPGA is reset, but the systime of both is restarted
+	EXPECT_EQ(1, count("config"));
+	EXPECT_EQ(2, count("prime"));
+	EXPECT_EQ(2, count("start"));
+	// disabled before priming and after starting
+	EXPECT_EQ(4, count("disable"));
+	for (size_t fpga : {0, 1}) {
+		EXPECT_LT(position("config", 1), position("prime", fpga));
+		for (size_t other : {0, 1}) {
+			EXPECT_LT(position("prime", fpga), position("start", other));
+		}
+	}
+	// the master is disabled last
+	EXPECT_EQ(std::make_pair(std::string("disable"), size_t(0)), steps.back());
+}
+
+TEST(FPGABringUp, RethrowsFirstError)
+{
+	size_t started = 0;
+	FPGABringUp bring_up;
+	bring_up.is_master = [](size_t) { return false; };
+	bring_up.config = [](size_t fpga) {
+		if (fpga == 1) {
+			throw std::runtime_error("config failed");
+		}
+	};
+	bring_up.disable_global = [](size_t) {};
+	bring_up.prime_systime_counter = [](size_t) {};
+	bring_up.start_systime_counter = [&started](size_t) {
+		#pragma omp atomic
+		++started;
+	};
+	EXPECT_THROW(bring_up.run(3), std::runtime_error);
+	EXPECT_EQ(0u, started);
+}
+
+} // namespace sthal
@@ -0,0 +1,387 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "halco/common/iter_all.h"
+
+#include "sthal/FPGA.h"
+#include "sthal/MappedPulseEvents.h"
+
+using namespace halco::hicann::v2;
+using namespace halco::common;
+
+namespace sthal {
+
+namespace {
+
+FPGA::PulseEvent make_event(
+	FPGA const& fpga, HICANNOnWafer const& hicann_c, GbitLinkOnHICANN const& link,
+	size_t addr, size_t time)
+{
+	HICANNGlobal const hicann(hicann_c, fpga.wafer());
+	return FPGA::PulseEvent(
+		FPGA::PulseEvent::dnc_address_t(hicann.toDNCOnFPGA().value()),
+		FPGA::PulseEvent::chip_address_t(hicann.toHICANNOnDNC().toEnum()),
+		FPGA::PulseEvent::channel_t(link.value()), HMF::HICANN::L1Address(addr), time);
+}
+
+} // namespace
+
+TEST(FPGA, ReceivedSpikesPerMerger)
+{
+	FPGA fpga(FPGAGlobal(FPGAOnWafer(Enum(0)), Wafer(Enum(0))));
+
+	HICANNOnWafer const h0 = HICANNOnDNC(Enum(0)).toHICANNOnWafer(fpga.coordinate());
+	HICANNOnWafer const h1 = HICANNOnDNC(Enum(5)).toHICANNOnWafer(fpga.coordinate());
+	GbitLinkOnHICANN const l0(0), l7(7);
+
+	FPGA::pulse_event_container_type events{
+		make_event(fpga, h1, l7, 3, 10), make_event(fpga, h0, l0, 1, 20),
+		make_event(fpga, h1, l7, 4, 30), make_event(fpga, h0, l7, 2, 40),
+		make_event(fpga, h1, l7, 5, 50)};
+	fpga.setReceivedPulseEvents(events);
+
+	EXPECT_EQ(1, fpga.getReceivedSpikesCount(h0, l0));
+	EXPECT_EQ(1, fpga.getReceivedSpikesCount(h0, l7));
+	EXPECT_EQ(0, fpga.getReceivedSpikesCount(h1, l0));
+	EXPECT_EQ(3, fpga.getReceivedSpikesCount(h1, l7));
+
+	size_t total = 0;
+	for (auto hicann : {h0, h1}) {
+		for (auto link : iter_all<GbitLinkOnHICANN>()) {
+			auto const& spikes = fpga.getReceivedSpikes(hicann, link);
+			ASSERT_EQ(fpga.getReceivedSpikesCount(hicann, link), spikes.size());
+			total += spikes.size();
+		}
+	}
+	EXPECT_EQ(events.size(), total);
+
+	// time order within a merger is retained
+	auto const& spikes = fpga.getReceivedSpikes(h1, l7);
+	ASSERT_EQ(3, spikes.size());
+	EXPECT_EQ(HMF::HICANN::L1Address(3), spikes[0].addr);
+	EXPECT_EQ(HMF::HICANN::L1Address(4), spikes[1].addr);
+	EXPECT_EQ(HMF::HICANN::L1Address(5), spikes[2].addr);
+	EXPECT_DOUBLE_EQ(30 / FPGA::dnc_freq, spikes[1].time);
+
+	fpga.insertReceivedPulseEvent(make_event(fpga, h0, l0, 6, 60));
+	EXPECT_EQ(2, fpga.getReceivedSpikesCount(h0, l0));
+	EXPECT_EQ(HMF::HICANN::L1Address(6), fpga.getReceivedSpikes(h0, l0).back().addr);
+	EXPECT_EQ(3, fpga.getReceivedSpikes(h1, l7).size());
+
+	// copies share the index until either of them is modified
+	FPGA const built_copy = fpga;
+	for (size_t ii = 0; ii < 100; ++ii) {
+		fpga.insertReceivedPulseEvent(make_event(fpga, h1, l0, ii % 64, 70 + ii));
+	}
+	FPGA const unbuilt_copy = fpga;
+	fpga.insertReceivedPulseEvent(make_event(fpga, h1, l0, 0, 200));
+	EXPECT_EQ(101, fpga.getReceivedSpikesCount(h1, l0));
+	EXPECT_EQ(100, unbuilt_copy.getReceivedSpikesCount(h1, l0));
+	EXPECT_EQ(0, built_copy.getReceivedSpikesCount(h1, l0));
+	EXPECT_EQ(2, built_copy.getReceivedSpikesCount(h0, l0));
+	EXPECT_EQ(2, fpga.getReceivedSpikesCount(h0, l0));
+
+	fpga.clearReceivedSpikes();
+	EXPECT_EQ(0, fpga.getReceivedSpikesCount(h1, l7));
+	EXPECT_TRUE(fpga.getReceivedSpikes(h1, l7).empty());
+}
+
+TEST(FPGA, SpikeBatchWriter)
+{
+	FPGAGlobal const fpga_c(FPGAOnWafer(Enum(0)), Wafer(Enum(0)));
+	FPGA direct(fpga_c), batched(fpga_c);
+
+	HICANNOnWafer const hicann = HICANNOnDNC(Enum(3)).toHICANNOnWafer(fpga_c);
+	SpikeVector const spikes{Spike(HMF::HICANN::L1Address(1), 3e-6),
+	                         Spike(HMF::HICANN::L1Address(2), 1e-6)};
+
+	{
+		FPGA::SpikeBatchWriter writer(batched, 2 * spikes.size());
+		for (auto link : {GbitLinkOnHICANN(1), GbitLinkOnHICANN(4)}) {
+			direct.addSendSpikes(hicann, link, spikes);
+			writer.add(hicann, link, spikes);
+		}
+		EXPECT_EQ(2 * spikes.size(), writer.size());
+
+		writer.commit();
+		EXPECT_EQ(0, writer.size());
+
+		direct.addSendSpikes(hicann, GbitLinkOnHICANN(7), spikes);
+		writer.add(hicann, GbitLinkOnHICANN(7), spikes);
+		writer.commit();
+
+		// dropped on destruction
+		writer.add(hicann, GbitLinkOnHICANN(2), spikes);
+	}
+
+	// batches abandoned by an exception leave the FPGA unchanged
+	try {
+		FPGA::SpikeBatchWriter writer(batched, spikes.size());
+		writer.add(hicann, GbitLinkOnHICANN(3), spikes);
+		throw std::runtime_error("abandoned batch");
+	} catch (std::runtime_error const&) {
+	}
+
+	direct.sortSpikes();
+	batched.sortSpikes();
+	EXPECT_EQ(direct.getSendSpikes(), batched.getSendSpikes());
+	EXPECT_EQ(
+	    direct.getSentSpikes(hicann, GbitLinkOnHICANN(4)).size(),
+	    batched.getSentSpikes(hicann, GbitLinkOnHICANN(4)).size());
+}
+
+TEST(ReceivedSpikeStatistics, Collect)
+{
+	FPGA fpga(FPGAGlobal(FPGAOnWafer(Enum(0)), Wafer(Enum(0))));
+
+	HICANNOnDNC const h0_on_dnc(Enum(0)), h1_on_dnc(Enum(5));
+	HICANNOnWafer const h0 = h0_on_dnc.toHICANNOnWafer(fpga.coordinate());
+	HICANNOnWafer const h1 = h1_on_dnc.toHICANNOnWafer(fpga.coordinate());
+	GbitLinkOnHICANN const l0(0), l7(7);
+
+	FPGA::pulse_event_container_type const trace{
+		make_event(fpga, h1, l7, 0, 10), make_event(fpga, h0, l0, 1, 20),
+		make_event(fpga, h1, l7, 4, 30), make_event(fpga, h0, l7, 0, 40),
+		make_event(fpga, h1, l7, 5, 50)};
+
+	auto events = trace;
+	auto const stats = ReceivedSpikeStatistics::collect(events, false, 10.);
+	EXPECT_EQ(trace, events);
+	EXPECT_EQ(5, stats.total);
+	EXPECT_EQ(2, stats.background);
+	EXPECT_EQ(0, stats.dropped);
+	EXPECT_EQ(10, stats.first_time);
+	EXPECT_EQ(50, stats.last_time);
+	EXPECT_DOUBLE_EQ(0.4, stats.background_fraction());
+	DNCOnFPGA const dnc = HICANNGlobal(h0, fpga.wafer()).toDNCOnFPGA();
+	EXPECT_EQ(2, stats.count(dnc, h0_on_dnc));
+	EXPECT_EQ(3, stats.counts[dnc][h1_on_dnc][l7]);
+	EXPECT_DOUBLE_EQ(3 / 10e-6, stats.rate(dnc, h1_on_dnc));
+
+	// the same HICANNOnDNC behind another DNC is counted separately
+	DNCOnFPGA const other_dnc(Enum((dnc.value() + 1) % DNCOnFPGA::size));
+	FPGA::pulse_event_container_type other{FPGA::PulseEvent(
+		FPGA::PulseEvent::dnc_address_t(other_dnc.value()),
+		FPGA::PulseEvent::chip_address_t(h0_on_dnc.toEnum()), FPGA::PulseEvent::channel_t(0),
+		HMF::HICANN::L1Address(1), 60)};
+	auto const other_stats = ReceivedSpikeStatistics::collect(other, false, 10.);
+	EXPECT_EQ(1, other_stats.count(other_dnc, h0_on_dnc));
+	EXPECT_EQ(0, other_stats.count(dnc, h0_on_dnc));
+
+	auto const dropped_stats = ReceivedSpikeStatistics::collect(events, true, 10.);
+	EXPECT_EQ(3, events.size());
+	EXPECT_EQ(2, dropped_stats.dropped);
+	EXPECT_EQ(stats.counts, dropped_stats.counts);
+	for (auto const& event : events) {
+		EXPECT_NE(HMF::HICANN::L1Address(0), event.getNeuronAddress());
+	}
+
+	// the trace is not necessarily ordered by time
+	FPGA::pulse_event_container_type unordered{
+		make_event(fpga, h0, l0, 1, 30), make_event(fpga, h0, l0, 2, 5),
+		make_event(fpga, h1, l7, 3, 60), make_event(fpga, h1, l7, 4, 20)};
+	auto const unordered_stats = ReceivedSpikeStatistics::collect(unordered, false, 10.);
+	EXPECT_EQ(5, unordered_stats.first_time);
+	EXPECT_EQ(60, unordered_stats.last_time);
+
+	fpga.setReceivedPulseEvents(std::move(events));
+	fpga.setReceivedSpikeStatistics(dropped_stats);
+	EXPECT_EQ(dropped_stats, fpga.getReceivedSpikeStatistics());
+	fpga.clearReceivedSpikes();
+	EXPECT_EQ(ReceivedSpikeStatistics(), fpga.getReceivedSpikeStatistics());
+}
+
+TEST(CompactPulseEvents, RoundTrip)
+{
+	FPGA fpga(FPGAGlobal(FPGAOnWafer(Enum(3)), Wafer(Enum(0))));
+
+	HICANNOnWafer const h0 = HICANNOnDNC(Enum(0)).toHICANNOnWafer(fpga.coordinate());
+	HICANNOnWafer const h1 = HICANNOnDNC(Enum(7)).toHICANNOnWafer(fpga.coordinate());
+
+	// includes unsorted timestamps, which are encoded as negative deltas
+	FPGA::pulse_event_container_type const events{
+		make_event(fpga, h1, GbitLinkOnHICANN(7), 63, 1000),
+		make_event(fpga, h0, GbitLinkOnHICANN(0), 0, 1001),
+		make_event(fpga, h1, GbitLinkOnHICANN(3), 17, 1001),
+		make_event(fpga, h0, GbitLinkOnHICANN(5), 42, 20),
+		make_event(fpga, h0, GbitLinkOnHICANN(5), 42, 1ull << 40)};
+
+	CompactPulseEvents const compact(events);
+	EXPECT_EQ(events.size(), compact.size());
+	EXPECT_EQ(events, compact.decode());
+	EXPECT_TRUE(CompactPulseEvents().decode().empty());
+}
+
+TEST(CompactPulseEvents, FPGASerialization)
+{
+	FPGAGlobal const fpga_c(FPGAOnWafer(Enum(0)), Wafer(Enum(0)));
+	boost::shared_ptr<FPGAShared> shared(new FPGAShared);
+	shared->setCompactSpikeArchive(true);
+	FPGA fpga(fpga_c, shared);
+
+	HICANNOnWafer const hicann = HICANNOnDNC(Enum(2)).toHICANNOnWafer(fpga_c);
+	fpga.addSendSpikes(
+	    hicann, GbitLinkOnHICANN(1),
+	    {Spike(HMF::HICANN::L1Address(1), 3e-6), Spike(HMF::HICANN::L1Address(2), 1e-6)});
+	fpga.sortSpikes();
+	fpga.addSendSpikes(hicann, GbitLinkOnHICANN(2), {Spike(HMF::HICANN::L1Address(3), 2e-6)});
+	fpga.setReceivedPulseEvents({make_event(fpga, hicann, GbitLinkOnHICANN(4), 5, 10)});
+
+	std::stringstream stream;
+	{
+		boost::archive::binary_oarchive ar(stream);
+		ar << fpga;
+	}
+	FPGA loaded;
+	{
+		boost::archive::binary_iarchive ar(stream);
+		ar >> loaded;
+	}
+	EXPECT_TRUE(loaded.commonFPGASettings()->getCompactSpikeArchive());
+	EXPECT_EQ(fpga.getReceivedSpikes().copy(), loaded.getReceivedSpikes().copy());
+	EXPECT_EQ(1, loaded.getReceivedSpikesCount(hicann, GbitLinkOnHICANN(4)));
+
+	// sent spikes are only accessible once the pending ones are sorted
+	fpga.sortSpikes();
+	loaded.sortSpikes();
+	EXPECT_EQ(fpga.getSendSpikes(), loaded.getSendSpikes());
+	EXPECT_EQ(3, loaded.getSendSpikes().size());
+}
+
+TEST(FPGA, MappedReceivedSpikes)
+{
+	boost::shared_ptr<FPGAShared> shared(new FPGAShared);
+	shared->setReceivedSpikesMapping(boost::filesystem::temp_directory_path().string());
+	FPGA mapped(FPGAGlobal(FPGAOnWafer(Enum(0)), Wafer(Enum(0))), shared);
+	FPGA in_memory(mapped.coordinate());
+
+	HICANNOnWafer const h0 = HICANNOnDNC(Enum(0)).toHICANNOnWafer(mapped.coordinate());
+	HICANNOnWafer const h1 = HICANNOnDNC(Enum(5)).toHICANNOnWafer(mapped.coordinate());
+	GbitLinkOnHICANN const l0(0), l7(7);
+
+	FPGA::pulse_event_container_type const events{
+		make_event(mapped, h1, l7, 3, 10), make_event(mapped, h0, l0, 1, 20),
+		make_event(mapped, h1, l7, 4, 30)};
+	mapped.setReceivedPulseEvents(events);
+	in_memory.setReceivedPulseEvents(events);
+
+	ASSERT_TRUE(mapped.hasMappedReceivedSpikes());
+	EXPECT_FALSE(in_memory.hasMappedReceivedSpikes());
+	EXPECT_EQ(events, mapped.getReceivedSpikes().copy());
+	EXPECT_EQ(events, mapped.getReceivedPulseEvents().copy());
+	EXPECT_EQ(2, mapped.getReceivedPulseEvents(h1, l7).size());
+	auto const& expected = in_memory.getReceivedSpikes(h1, l7);
+	auto const& spikes = mapped.getReceivedSpikes(h1, l7);
+	ASSERT_EQ(expected.size(), spikes.size());
+	for (size_t ii = 0; ii < spikes.size(); ++ii) {
+		EXPECT_EQ(expected[ii].addr, spikes[ii].addr);
+		EXPECT_DOUBLE_EQ(expected[ii].time, spikes[ii].time);
+	}
+
+	mapped.insertReceivedPulseEvent(make_event(mapped, h0, l0, 6, 60));
+	in_memory.insertReceivedPulseEvent(make_event(mapped, h0, l0, 6, 60));
+	EXPECT_EQ(2, mapped.getReceivedSpikesCount(h0, l0));
+	EXPECT_EQ(in_memory.getReceivedSpikes().copy(), mapped.getReceivedPulseEvents().copy());
+
+	// inserts grow the mapping in place, copies keep their events
+	FPGA const copy = mapped;
+	for (size_t ii = 0; ii < 10; ++ii) {
+		auto const event = make_event(mapped, ii % 2 ? h0 : h1, ii % 3 ? l0 : l7, ii, 70 + ii);
+		mapped.insertReceivedPulseEvent(event);
+		in_memory.insertReceivedPulseEvent(event);
+	}
+	ASSERT_TRUE(mapped.hasMappedReceivedSpikes());
+	EXPECT_EQ(in_memory.getReceivedSpikes().copy(), mapped.getReceivedPulseEvents().copy());
+	EXPECT_EQ(4, copy.getReceivedPulseEvents().size());
+	for (auto const& merger : {l0, l7}) {
+		for (auto const& hicann : {h0, h1}) {
+			EXPECT_EQ(
+			    in_memory.getReceivedPulseEvents(hicann, merger).copy(),
+			    mapped.getReceivedPulseEvents(hicann, merger).copy());
+		}
+	}
+
+	// spike files are decoded straight into the mapping
+	boost::filesystem::path const filename =
+	    boost::filesystem::temp_directory_path() /
+	    boost::filesystem::unique_path("sthal-test-spikes-%%%%-%%%%");
+	in_memory.save_spikes(filename.c_str());
+	FPGA loaded(mapped.coordinate(), shared);
+	loaded.load_spikes(filename.c_str());
+	boost::filesystem::remove(filename);
+	EXPECT_TRUE(loaded.hasMappedReceivedSpikes());
+	EXPECT_EQ(in_memory.getReceivedSpikes().copy(), loaded.getReceivedPulseEvents().copy());
+	EXPECT_EQ(
+	    in_memory.getReceivedSpikesCount(h1, l7), loaded.getReceivedSpikesCount(h1, l7));
+
+	mapped.clearReceivedSpikes();
+	EXPECT_FALSE(mapped.hasMappedReceivedSpikes());
+	EXPECT_TRUE(mapped.getReceivedSpikes().empty());
+}
+
+TEST(MappedPulseEvents, ReleaseKeepsEvents)
+{
+	size_t const size = 3 * boost::interprocess::mapped_region::get_page_size();
+	MappedPulseEvents mapping(boost::filesystem::temp_directory_path().string(), size);
+	for (size_t ii = 0; ii < size; ++ii) {
+		mapping.data()[ii] = FPGA::PulseEvent(
+			FPGA::PulseEvent::dnc_address_t(0), FPGA::PulseEvent::chip_address_t(Enum(0)),
+			FPGA::PulseEvent::channel_t(0), HMF::HICANN::L1Address(ii % 64), ii);
+	}
+	// unaligned ranges and empty ranges
+	mapping.release(1, size - 1);
+	mapping.release(5, 5);
+	mapping.release(0, size);
+	for (size_t ii = 0; ii < size; ++ii) {
+		ASSERT_EQ(ii, mapping.data()[ii].getTime());
+		ASSERT_EQ(HMF::HICANN::L1Address(ii % 64), mapping.data()[ii].getNeuronAddress());
+	}
+}
+
+TEST(FPGA, ConcurrentSpikeGetters)
+{
+	FPGA fpga(FPGAGlobal(FPGAOnWafer(Enum(0)), Wafer(Enum(0))));
+	auto const hicanns = {HICANNOnDNC(Enum(0)).toHICANNOnWafer(fpga.coordinate()),
+	                      HICANNOnDNC(Enum(7)).toHICANNOnWafer(fpga.coordinate())};
+
+	FPGA::pulse_event_container_type events;
+	for (size_t ii = 0; ii < 1000; ++ii) {
+		for (auto hicann : hicanns) {
+			GbitLinkOnHICANN const link(ii % GbitLinkOnHICANN::size);
+			events.push_back(make_event(fpga, hicann, link, ii % 64, ii));
+			fpga.addSendSpikes(hicann, link, {Spike(HMF::HICANN::L1Address(ii % 64), ii * 1e-6)});
+		}
+	}
+	fpga.setReceivedPulseEvents(events);
+	fpga.sortSpikes();
+
+	FPGA const& const_fpga = fpga;
+	std::vector<std::thread> threads;
+	std::vector<size_t> received(8, 0), sent(8, 0);
+	for (size_t tt = 0; tt < received.size(); ++tt) {
+		threads.emplace_back([&, tt]() {
+			for (auto hicann : hicanns) {
+				for (auto link : iter_all<GbitLinkOnHICANN>()) {
+					received[tt] += const_fpga.getReceivedSpikes(hicann, link).size();
+					sent[tt] += const_fpga.getSentSpikes(hicann, link).size();
+				}
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	for (size_t tt = 0; tt < received.size(); ++tt) {
+		EXPECT_EQ(events.size(), received[tt]);
+		EXPECT_EQ(events.size(), sent[tt]);
+	}
+}
+
+} // namespace sthal
@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+
+#include "halco/common/iter_all.h"
+#include "sthal/FloatingGates.h"
+
+using namespace halco::hicann::v2;
+using namespace halco::common;
+
+namespace sthal {
+
+TEST(FloatingGates, PackedSerialization) {
+	FloatingGates fg;
+	for (auto block : iter_all<FGBlockOnHICANN>()) {
+		for (auto cell : iter_all<FGCellOnFGBlock>()) {
+			fg[block].setRaw(cell, (cell.toEnum().value() * 7 + block.toEnum().value()) % 1024);
+		}
+	}
+	fg.setNoProgrammingPasses(Enum(3));
+
+	std::stringstream stream;
+	{
+		boost::archive::binary_oarchive ar(stream);
+		ar << fg;
+	}
+	// 10 bit per cell
+	EXPECT_LT(
+		stream.str().size(), 2 * FGBlockOnHICANN::size * FGCellOnFGBlock::enum_type::size);
+
+	FloatingGates loaded;
+	{
+		boost::archive::binary_iarchive ar(stream);
+		ar >> loaded;
+	}
+	EXPECT_EQ(fg, loaded);
+}
+
+} // sthal
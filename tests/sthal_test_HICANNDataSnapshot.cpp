@@ -0,0 +1,35 @@
+#include <gtest/gtest.h>
+
+#include "sthal/HICANNDataSnapshot.h"
+
+using namespace halco::hicann::v2;
+using namespace halco::common;
+
+namespace sthal {
+
+TEST(HICANNDataSnapshot, SharesUnchangedBlocks) {
+	HICANNData hicann;
+	hicann.synapses[SynapseOnHICANN(Enum(42))].weight = HMF::HICANN::SynapseWeight(5);
+
+	HICANNDataSnapshot const first(hicann);
+	EXPECT_EQ(0u, first.shared_blocks());
+	EXPECT_EQ(hicann.synapses, first.synapses());
+
+	HICANNDataSnapshot const second(hicann, &first);
+	EXPECT_EQ(9u, second.shared_blocks());
+	EXPECT_EQ(&first.synapses(), &second.synapses());
+
+	hicann.synapses[SynapseOnHICANN(Enum(42))].weight = HMF::HICANN::SynapseWeight(6);
+	HICANNDataSnapshot const third(hicann, &second);
+	EXPECT_EQ(8u, third.shared_blocks());
+	EXPECT_NE(&second.synapses(), &third.synapses());
+	EXPECT_EQ(&second.floating_gates(), &third.floating_gates());
+	EXPECT_EQ(HMF::HICANN::SynapseWeight(5), second.synapses()[SynapseOnHICANN(Enum(42))].weight);
+	EXPECT_EQ(HMF::HICANN::SynapseWeight(6), third.synapses()[SynapseOnHICANN(Enum(42))].weight);
+
+	HICANNData restored;
+	third.copy_to(restored);
+	EXPECT_EQ(hicann, restored);
+}
+
+} // sthal
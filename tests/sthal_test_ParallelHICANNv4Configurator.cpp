@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "halco/common/iter_all.h"
+#include "sthal/FloatingGates.h"
+#include "sthal/ParallelHICANNv4Configurator.h"
+#include "sthal/ParallelHICANNv4SmartConfigurator.h"
+
+using namespace halco::hicann::v2;
+using namespace halco::common;
+
+namespace sthal {
+
+namespace {
+
+void set_fg_row(
+	FloatingGates& fg, FGBlockOnHICANN const& block, FGRowOnFGBlock const& row, size_t value)
+{
+	// shared cell and all neuron cells
+	for (size_t x = 0; x < 129; ++x) {
+		fg[block].setRaw(FGCellOnFGBlock(X(x), row), value);
+	}
+}
+
+::HMF::HICANN::FGRowOnFGBlock4 neuron_rows(::HMF::HICANN::neuron_parameter const param)
+{
+	return {{::HMF::HICANN::getNeuronRow(FGBlockOnHICANN(Enum(0)), param),
+	         ::HMF::HICANN::getNeuronRow(FGBlockOnHICANN(Enum(1)), param),
+	         ::HMF::HICANN::getNeuronRow(FGBlockOnHICANN(Enum(2)), param),
+	         ::HMF::HICANN::getNeuronRow(FGBlockOnHICANN(Enum(3)), param)}};
+}
+
+} // namespace
+
+TEST(ParallelHICANNv4Configurator, SynapseDriverOrder) {
+	typedef ParallelHICANNv4Configurator::SynapseWriteOrder order_t;
+
+	for (auto order : {order_t::Sequential, order_t::Alternating}) {
+		auto const drivers = ParallelHICANNv4Configurator::synapse_driver_order(order);
+		ASSERT_EQ(SynapseDriverOnHICANN::size, drivers.size());
+		std::set<SynapseDriverOnHICANN> const unique(drivers.begin(), drivers.end());
+		ASSERT_EQ(SynapseDriverOnHICANN::size, unique.size());
+	}
+
+	auto const alternating = ParallelHICANNv4Configurator::synapse_driver_order(
+		order_t::Alternating);
+	for (size_t ii = 1; ii < alternating.size(); ++ii) {
+		EXPECT_NE(
+			alternating[ii - 1].toSynapseArrayOnHICANN(),
+			alternating[ii].toSynapseArrayOnHICANN());
+	}
+
+	ParallelHICANNv4Configurator configurator;
+	EXPECT_EQ(order_t::Sequential, configurator.getSynapseWriteOrder());
+	configurator.setSynapseWriteOrder(order_t::Alternating);
+	EXPECT_EQ(order_t::Alternating, configurator.getSynapseWriteOrder());
+}
+
+TEST(ParallelHICANNv4Configurator, FGWriteQueues) {
+	// "w<hicann><step>" for each write, "-<hicann>" for each wait
+	std::vector<std::string> log;
+	ParallelHICANNv4Configurator::run_fg_write_queues(
+		{3, 1, 0, 2},
+		[&log](size_t hicann, size_t step) {
+			// step 0 on HICANN 3 writes nothing
+			if (hicann == 3 && step == 0) {
+				return false;
+			}
+			log.push_back("w" + std::to_string(hicann) + std::to_string(step));
+			return true;
+		},
+		[&log](size_t hicann) { log.push_back("-" + std::to_string(hicann)); });
+
+	// waits follow the issue order and the next write on a HICANN directly follows the
+	// wait for it, HICANNs without further writes leave the queue
+	std::vector<std::string> const expected{
+		"w00", "w10", "w31", "-0", "w01", "-1", "-3", "-0", "w02", "-0"};
+	EXPECT_EQ(expected, log);
+}
+
+TEST(ParallelHICANNv4SmartConfigurator, ChangedFGRows) {
+	typedef ParallelHICANNv4Configurator::row_list_t row_list_t;
+	typedef ParallelHICANNv4SmartConfigurator smart_t;
+	size_t const limit = 800;
+
+	FloatingGates const written;
+	FloatingGates fg = written;
+	EXPECT_TRUE(smart_t::changed_fg_rows(written, fg, limit).empty());
+
+	// voltage rows are programmed normally
+	FGBlockOnHICANN const block(Enum(3));
+	set_fg_row(fg, block, ParallelHICANNv4Configurator::VOLTAGE_ROWS[0][3], 300);
+	row_list_t const voltage{ParallelHICANNv4Configurator::VOLTAGE_ROWS[0]};
+	ASSERT_EQ(voltage, smart_t::changed_fg_rows(written, fg, limit));
+	auto split = ParallelHICANNv4Configurator::split_fg_rows(fg, voltage, limit);
+	EXPECT_EQ(voltage, split.first);
+	EXPECT_TRUE(split.second.empty());
+
+	// current rows are reported with the row of the parameter in each block, even if
+	// only a single block changed
+	fg = written;
+	auto const param = ::HMF::HICANN::neuron_parameter::I_gl;
+	set_fg_row(fg, FGBlockOnHICANN(Enum(1)), neuron_rows(param)[1], 100);
+	row_list_t const current{neuron_rows(param)};
+	ASSERT_EQ(current, smart_t::changed_fg_rows(written, fg, limit));
+	split = ParallelHICANNv4Configurator::split_fg_rows(fg, current, limit);
+	EXPECT_EQ(current, split.first);
+	EXPECT_TRUE(split.second.empty());
+
+	// ... and programmed fast upwards like in a full write if high in any block
+	set_fg_row(fg, FGBlockOnHICANN(Enum(1)), neuron_rows(param)[1], 1000);
+	ASSERT_EQ(current, smart_t::changed_fg_rows(written, fg, limit));
+	split = ParallelHICANNv4Configurator::split_fg_rows(fg, current, limit);
+	EXPECT_TRUE(split.first.empty());
+	EXPECT_EQ(current, split.second);
+	auto const high = ParallelHICANNv4Configurator::current_rows(fg, limit).second;
+	EXPECT_NE(high.end(), std::find(high.begin(), high.end(), current[0]));
+}
+
+TEST(ParallelHICANNv4SmartConfigurator, SameProgrammingPasses) {
+	typedef ParallelHICANNv4SmartConfigurator smart_t;
+
+	FloatingGates const written;
+	FloatingGates fg = written;
+	EXPECT_TRUE(smart_t::same_programming_passes(written, fg));
+
+	// values do not matter
+	set_fg_row(fg, FGBlockOnHICANN(Enum(0)), FGRowOnFGBlock(0), 42);
+	EXPECT_TRUE(smart_t::same_programming_passes(written, fg));
+
+	fg.setNoProgrammingPasses(Enum(size_t(written.getNoProgrammingPasses()) + 1));
+	EXPECT_FALSE(smart_t::same_programming_passes(written, fg));
+
+	fg = written;
+	ASSERT_LT(0u, size_t(fg.getNoProgrammingPasses()));
+	FGConfig cfg = fg.getFGConfig(Enum(0));
+	cfg.maxcycle = (cfg.maxcycle == 31) ? 30 : 31;
+	fg.setFGConfig(Enum(0), cfg);
+	EXPECT_FALSE(smart_t::same_programming_passes(written, fg));
+}
+
+} // sthal
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include <boost/filesystem.hpp>
+
+#include "sthal/ParallelHICANNv4SmartConfigurator.h"
+#include "sthal/SmartConfiguratorStateStore.h"
+
+using namespace halco::hicann::v2;
+using namespace halco::common;
+
+namespace sthal {
+
+class SmartConfiguratorStateStoreTest : public ::testing::Test
+{
+protected:
+	SmartConfiguratorStateStoreTest() :
+		directory(
+			boost::filesystem::temp_directory_path() /
+			boost::filesystem::unique_path("sthal-state-%%%%-%%%%-%%%%-%%%%"))
+	{}
+
+	~SmartConfiguratorStateStoreTest()
+	{
+		boost::filesystem::remove_all(directory);
+	}
+
+	Status status() const
+	{
+		Status st;
+		st.fpga_id.fill(0);
+		st.fpga_rev.fill(0);
+		st.fpga_id[3] = 0xdeadbeef;
+		st.git_rev_sthal = "abc";
+		return st;
+	}
+
+	boost::filesystem::path const directory;
+};
+
+TEST_F(SmartConfiguratorStateStoreTest, LoadsOnlyMatchingState) {
+	SmartConfiguratorStateStore const store(directory.string(), Wafer(Enum(33)));
+	auto const key = SmartConfiguratorStateStore::key(status());
+
+	ParallelHICANNv4SmartConfigurator loaded;
+	EXPECT_FALSE(store.load(key, loaded));
+
+	ParallelHICANNv4SmartConfigurator configurator;
+	configurator.note_fpga_config(FPGAOnWafer(Enum(3)));
+	store.save(key, configurator);
+	EXPECT_TRUE(boost::filesystem::exists(store.path()));
+	EXPECT_TRUE(store.load(key, loaded));
+
+	// different FPGA
+	Status other_fpga = status();
+	other_fpga.fpga_id[3] = 0xcafe;
+	EXPECT_FALSE(store.load(SmartConfiguratorStateStore::key(other_fpga), loaded));
+
+	// different software
+	Status other_software = status();
+	other_software.git_rev_sthal = "def";
+	EXPECT_FALSE(store.load(SmartConfiguratorStateStore::key(other_software), loaded));
+
+	// other wafers use their own files
+	SmartConfiguratorStateStore const other_wafer(directory.string(), Wafer(Enum(30)));
+	EXPECT_NE(store.path(), other_wafer.path());
+	EXPECT_FALSE(other_wafer.load(key, loaded));
+
+	store.invalidate();
+	EXPECT_FALSE(store.load(key, loaded));
+}
+
+TEST_F(SmartConfiguratorStateStoreTest, DoesNotStoreSystimeStart) {
+	SmartConfiguratorStateStore const store(directory.string(), Wafer(Enum(33)));
+	auto const key = SmartConfiguratorStateStore::key(status());
+
+	ParallelHICANNv4SmartConfigurator configurator;
+	configurator.note_fpga_config(FPGAOnWafer(Enum(3)));
+	configurator.note_systime_start();
+	EXPECT_FALSE(configurator.systime_start_wanted());
+	store.save(key, configurator);
+
+	ParallelHICANNv4SmartConfigurator loaded;
+	ASSERT_TRUE(store.load(key, loaded));
+	EXPECT_FALSE(loaded.fpga_config_wanted(FPGAOnWafer(Enum(3))));
+	EXPECT_TRUE(loaded.fpga_config_wanted(FPGAOnWafer(Enum(4))));
+	// the counters are started again by each process
+	EXPECT_TRUE(loaded.systime_start_wanted());
+}
+
+} // sthal
@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <sstream>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/xml_iarchive.hpp>
+#include <boost/archive/xml_oarchive.hpp>
+#include <boost/serialization/array.hpp>
+
+#include "halco/common/iter_all.h"
+#include "sthal/SynapseArray.h"
+
+using namespace halco::hicann::v2;
+using namespace halco::common;
+
+namespace sthal {
+
+TEST(SynapseArray, TracksModifiedRows) {
+	SynapseArray synapses;
+	SynapseArray::generation_type const start = synapses.generation();
+	EXPECT_TRUE(synapses.changed_weights(start).empty());
+	EXPECT_TRUE(synapses.changed_decoders(start).empty());
+
+	SynapseDriverOnHICANN const driver(Enum(17));
+	SynapseRowOnHICANN const row(driver, RowOnSynapseDriver(bottom));
+	synapses[row].weights[SynapseColumnOnHICANN(3)] = HMF::HICANN::SynapseWeight(7);
+
+	auto const weights = synapses.changed_weights(start);
+	ASSERT_EQ(1u, weights.size());
+	EXPECT_EQ(row, weights[0]);
+	auto const decoders = synapses.changed_decoders(start);
+	ASSERT_EQ(1u, decoders.size());
+	EXPECT_EQ(driver, decoders[0]);
+	EXPECT_TRUE(synapses.changed_drivers(start).empty());
+
+	// const access is not tracked
+	SynapseArray::generation_type const after_write = synapses.generation();
+	SynapseArray const& const_synapses = synapses;
+	EXPECT_EQ(HMF::HICANN::SynapseWeight(7),
+	          const_synapses[row].weights[SynapseColumnOnHICANN(3)]);
+	EXPECT_EQ(after_write, synapses.generation());
+
+	synapses[driver][top].set_decoder(top, HMF::HICANN::DriverDecoder(1));
+	EXPECT_EQ(1u, synapses.changed_drivers(after_write).size());
+
+	synapses.set_all_weights(HMF::HICANN::SynapseWeight(1));
+	EXPECT_EQ(SynapseRowOnHICANN::enum_type::size, synapses.changed_weights(after_write).size());
+}
+
+TEST(SynapseArray, TracksWritesThroughHeldProxies) {
+	SynapseArray synapses;
+	SynapseOnHICANN const synapse(Enum(42 * SynapseColumnOnHICANN::size + 5));
+	SynapseRowOnHICANN const row = synapse.toSynapseRowOnHICANN();
+	uint64_t const initial_hash = synapses.content_hash();
+	SynapseArray::generation_type before;
+	{
+		// proxies obtained before the generation is read, e.g. across configure()
+		SynapseRowProxy row_proxy = synapses[row];
+		SynapseProxy synapse_proxy = synapses[synapse];
+		before = synapses.generation();
+		EXPECT_EQ(initial_hash, synapses.content_hash());
+
+		row_proxy.weights[SynapseColumnOnHICANN(3)] = HMF::HICANN::SynapseWeight(7);
+		synapse_proxy.decoder = HMF::HICANN::SynapseDecoder(2);
+
+		EXPECT_LT(before, synapses.generation());
+		auto const weights = synapses.changed_weights(before);
+		ASSERT_EQ(1u, weights.size());
+		EXPECT_EQ(row, weights[0]);
+		auto const decoders = synapses.changed_decoders(before);
+		ASSERT_EQ(1u, decoders.size());
+		EXPECT_EQ(row.toSynapseDriverOnHICANN(), decoders[0]);
+		EXPECT_NE(initial_hash, synapses.content_hash());
+		EXPECT_EQ(SynapseArray(synapses).content_hash(), synapses.content_hash());
+
+		before = synapses.generation();
+		synapse_proxy.weight = HMF::HICANN::SynapseWeight(3);
+	}
+	// writes right before the proxies are released are noticed as well
+	EXPECT_EQ(1u, synapses.changed_weights(before).size());
+	EXPECT_EQ(SynapseArray(synapses).content_hash(), synapses.content_hash());
+
+	// once released, rows are not reported anymore
+	SynapseArray::generation_type const released = synapses.generation();
+	EXPECT_EQ(released, synapses.generation());
+	EXPECT_TRUE(synapses.changed_weights(released).empty());
+}
+
+TEST(SynapseArray, HashNoticesWritesThroughDriverReferences) {
+	SynapseArray synapses;
+	SynapseDriverOnHICANN const driver(Enum(3));
+	auto& driver_ref = synapses[driver];
+	uint64_t const initial_hash = synapses.content_hash();
+
+	driver_ref[top].set_decoder(top, HMF::HICANN::DriverDecoder(1));
+	EXPECT_NE(initial_hash, synapses.content_hash());
+	EXPECT_EQ(SynapseArray(synapses).content_hash(), synapses.content_hash());
+}
+
+TEST(SynapseArray, CopiesStartNewHistory) {
+	SynapseArray synapses;
+	synapses[SynapseOnHICANN(Enum(100))].weight = HMF::HICANN::SynapseWeight(3);
+
+	SynapseArray const copy = synapses;
+	EXPECT_EQ(synapses, copy);
+	EXPECT_NE(synapses.history(), copy.history());
+	EXPECT_EQ(0u, copy.generation());
+}
+
+TEST(SynapseArray, ContentHash) {
+	SynapseArray synapses;
+	uint64_t const initial = synapses.content_hash();
+	EXPECT_EQ(initial, SynapseArray().content_hash());
+
+	SynapseOnHICANN const synapse(Enum(4242));
+	synapses[synapse].weight = HMF::HICANN::SynapseWeight(9);
+	uint64_t const modified = synapses.content_hash();
+	EXPECT_NE(initial, modified);
+
+	SynapseArray const copy = synapses;
+	EXPECT_EQ(modified, copy.content_hash());
+
+	synapses[synapse].weight = HMF::HICANN::SynapseWeight(0);
+	EXPECT_EQ(initial, synapses.content_hash());
+}
+
+TEST(SynapseArray, PackedSerialization) {
+	SynapseArray synapses;
+	for (auto synapse : iter_all<SynapseOnHICANN>()) {
+		size_t const ii = synapse.toEnum().value();
+		synapses[synapse].weight = HMF::HICANN::SynapseWeight(ii % 16);
+		synapses[synapse].decoder = HMF::HICANN::SynapseDecoder((ii / 7) % 4);
+	}
+
+	std::stringstream binary;
+	{
+		boost::archive::binary_oarchive ar(binary);
+		ar << synapses;
+	}
+	// drivers are stored element by element, measure their payload separately
+	std::array<SynapseArray::driver_type, SynapseArray::no_drivers> drivers;
+	for (auto driver : iter_all<SynapseDriverOnHICANN>()) {
+		drivers[driver.line()] = static_cast<SynapseArray const&>(synapses)[driver];
+	}
+	std::stringstream drivers_binary;
+	{
+		boost::archive::binary_oarchive ar(drivers_binary);
+		ar << drivers;
+	}
+	// half a byte per weight and per decoder, i.e. one byte per synapse (unpacked: two),
+	// on top of the drivers and a small overhead for class information and block size
+	size_t const packed_bytes = SynapseOnHICANN::enum_type::size;
+	EXPECT_GE(binary.str().size(), packed_bytes);
+	EXPECT_LT(binary.str().size(), packed_bytes + drivers_binary.str().size() + 64);
+	SynapseArray loaded;
+	{
+		boost::archive::binary_iarchive ar(binary);
+		ar >> loaded;
+	}
+	EXPECT_EQ(synapses, loaded);
+
+	// xml archives are not packed
+	std::stringstream xml;
+	{
+		boost::archive::xml_oarchive ar(xml);
+		ar << boost::serialization::make_nvp("synapses", synapses);
+	}
+	SynapseArray loaded_xml;
+	{
+		boost::archive::xml_iarchive ar(xml);
+		ar >> boost::serialization::make_nvp("synapses", loaded_xml);
+	}
+	EXPECT_EQ(synapses, loaded_xml);
+}
+
+} // sthal
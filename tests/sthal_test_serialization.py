@@ -38,6 +38,105 @@ class TestSerialization(unittest.TestCase):
         h.set_neuron_size(2)
         self.assertNotEqual(w, w2)
 
+    def test_wafer_dumpnload_compressed(self):
+        import tempfile
+        wafer_c = C.Wafer(33)
+        w = pysthal.Wafer(wafer_c)
+        h_c = C.HICANNOnWafer(Enum(297))
+        w[h_c].set_neuron_size(4)
+        for suffix in [".bin.gz", ".xml.gz", ".bin.bz2"]:
+            with tempfile.NamedTemporaryFile(suffix=suffix) as f:
+                w.dump(f.name, True)
+                w2 = pysthal.Wafer(wafer_c)
+                w2.load(f.name)
+            self.assertEqual(w, w2, suffix)
+
+    def test_wafer_dumpnload_chunked(self):
+        import tempfile
+        wafer_c = C.Wafer(33)
+        w = pysthal.Wafer(wafer_c)
+        for h_enum in [297, 298, 300]:
+            w[C.HICANNOnWafer(Enum(h_enum))].set_neuron_size(4)
+        with tempfile.NamedTemporaryFile(suffix=".chunked") as f:
+            w.dump(f.name, True)
+            w2 = pysthal.Wafer(wafer_c)
+            w2.load(f.name)
+        self.assertEqual(w, w2)
+        h_c = C.HICANNOnWafer(Enum(297))
+        h2 = w2[h_c]
+        self.assertTrue(h2.has_wafer())
+        self.assertEqual(w.getAllocatedHicannCoordinates(),
+                         w2.getAllocatedHicannCoordinates())
+        # change something to ensure that it's not a mere pointer copy
+        w[h_c].set_neuron_size(2)
+        self.assertNotEqual(w, w2)
+
+    def test_wafer_open_lazy(self):
+        import tempfile
+        wafer_c = C.Wafer(33)
+        w = pysthal.Wafer(wafer_c)
+        for h_enum in [297, 298, 300]:
+            w[C.HICANNOnWafer(Enum(h_enum))].set_neuron_size(4)
+        h_c = C.HICANNOnWafer(Enum(298))
+        with tempfile.NamedTemporaryFile(suffix=".chunked") as f:
+            w.dump(f.name, True)
+            w2 = pysthal.Wafer(wafer_c)
+            w2.open_lazy(f.name)
+            self.assertEqual(w.getAllocatedHicannCoordinates(),
+                             w2.getAllocatedHicannCoordinates())
+            self.assertEqual(w[h_c], w2[h_c])
+            self.assertTrue(w2[h_c].has_wafer())
+            self.assertEqual(w, w2)
+            # enumerating accessors also see HICANNs which are not loaded yet
+            w3 = pysthal.Wafer(wafer_c)
+            w3.open_lazy(f.name)
+            self.assertEqual(list(w.status().hicanns), list(w3.status().hicanns))
+            fpga_c = C.HICANNGlobal(h_c, wafer_c).toFPGAOnWafer()
+            self.assertEqual(list(w[fpga_c].getAllocatedHICANNs()),
+                             list(w3[fpga_c].getAllocatedHICANNs()))
+        with tempfile.NamedTemporaryFile() as f:
+            w.dump(f.name, True)
+            with self.assertRaises(RuntimeError):
+                w2.open_lazy(f.name)
+
+    def test_wafer_dumpnload_delta(self):
+        import os
+        import shutil
+        import tempfile
+        wafer_c = C.Wafer(33)
+        w = pysthal.Wafer(wafer_c)
+        for h_enum in [297, 298, 300]:
+            w[C.HICANNOnWafer(Enum(h_enum))].set_neuron_size(4)
+        directory = tempfile.mkdtemp()
+        try:
+            base = os.path.join(directory, "base.bin")
+            deltas = [os.path.join(directory, "delta{}.chunked".format(ii))
+                      for ii in range(2)]
+            w.dump(base)
+            h_c = C.HICANNOnWafer(Enum(297))
+            w[h_c].set_neuron_size(2)
+            w.dump_delta(base, deltas[0])
+            w1 = pysthal.Wafer(wafer_c)
+            w1.load(base, deltas[:1])
+            self.assertEqual(w, w1)
+            # chained delta with a newly allocated HICANN
+            w[h_c].set_neuron_size(4)
+            w[C.HICANNOnWafer(Enum(301))].set_neuron_size(8)
+            w.dump_delta(w1, deltas[1])
+            w2 = pysthal.Wafer(wafer_c)
+            w2.load(base, deltas)
+            self.assertEqual(w, w2)
+            self.assertTrue(w2[h_c].has_wafer())
+            # deltas only fit their base, verified if strict
+            w3 = pysthal.Wafer(wafer_c)
+            with self.assertRaises(Exception):
+                w3.load(base, deltas[1:], True)
+            w3.load(base, deltas[1:])
+            with self.assertRaises(Exception):
+                w3.load(deltas[0])
+        finally:
+            shutil.rmtree(directory)
+
     def test_wafer_copy(self):
         import copy
         wafer_c = C.Wafer(33)
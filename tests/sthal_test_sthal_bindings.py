@@ -99,6 +99,33 @@ class Test_PyhalbeBindings(PyhalbeTest):
         numpy.testing.assert_array_equal(addrs, numpy.array(addrs_t, dtype=numpy.ushort))
 
 
+    def test_SpikeTrain(self):
+        import pysthal
+        from pyhalbe import HICANN
+
+        addrs = numpy.array(numpy.random.randint(64, size=100), dtype=numpy.uint16)
+        times = numpy.cumsum(numpy.random.poisson(10.0, size=100)) * 1.e-6
+        in_spikes = pysthal.Vector_Spike()
+        for addr, t in zip(addrs, times):
+            in_spikes.append(pysthal.Spike(HICANN.L1Address(addr), t))
+
+        train = pysthal.SpikeTrain(in_spikes)
+        self.assertEqual(len(times), train.size())
+
+        # views onto the spike train, which is kept alive by them
+        addrs_t = train.addrs
+        ticks_t = train.times
+        del train
+        self.assertEqual(numpy.uint16, addrs_t.dtype)
+        self.assertEqual(numpy.uint64, ticks_t.dtype)
+        self.assertFalse(ticks_t.flags.writeable)
+        numpy.testing.assert_array_equal(addrs, addrs_t)
+        numpy.testing.assert_allclose(times, ticks_t / pysthal.FPGA.dnc_freq,
+                                      rtol=0.0, atol=1.0/250e6)
+
+        train = pysthal.SpikeTrain(in_spikes)
+        numpy.testing.assert_allclose(times, train.times_in_s(), rtol=0.0, atol=1.0/250e6)
+
     def test_AnalogRecorder(self):
         import pysthal
         self.assertIs(pysthal.AnalogRecorder.voltage_type, float)